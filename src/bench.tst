@@ -0,0 +1,24 @@
+; benchmark task set: 20 tasks, 89% load, hyperperiod 720720
+title Benchmark
+tasks 20
+task T01 HIGH 110 5
+task T02 LOW 126 6
+task T03 HIGH 140 6
+task T04 LOW 154 7
+task T05 HIGH 165 7
+task T06 LOW 195 9
+task T07 HIGH 208 9
+task T08 LOW 231 10
+task T09 HIGH 252 11
+task T10 LOW 273 12
+task T11 HIGH 280 13
+task T12 LOW 330 15
+task T13 HIGH 364 16
+task T14 LOW 390 18
+task T15 HIGH 455 20
+task T16 LOW 495 22
+task T17 HIGH 560 25
+task T18 LOW 585 26
+task T19 HIGH 693 31
+task T20 LOW 720 32
+end
@@ -0,0 +1,343 @@
+/*
+ * Compact skip list
+ *
+ * See cskipl.h
+ *
+ * The nodes are allocated in 8 byte units from one array, which doubles
+ * when it is full, and the links are the index of the first unit of the
+ * node they point to. The node 0 is the header, of the highest level, so
+ * a link 0 is the end of the list. A node of level L has L+1 links of 4
+ * bytes after its key and tie: 24 bytes for most of them, against about
+ * 48 for a node of skipl.c, plus its share of the allocation chunks.
+ *
+ * Deleted nodes are kept in a free list by level and reused by nodes of the
+ * same level, so the array never shrinks. There are no backward links: a
+ * node is deleted by searching its key.
+ */
+
+#include <stdio.h>  /* for stderr */
+#include <stdlib.h> /* for realloc() */
+#include <string.h> /* for memcpy() */
+#include <limits.h> /* for UINT_MAX */
+
+#ifdef DMALLOC
+#include "dmalloc.h"
+#endif
+
+#include "cskipl.h"
+
+/* for p=1/4 enough for 4^16 nodes */
+#define MaxLevels       16
+/* initial state of the random generator of each list */
+#define DefaultSeed     2463534242U
+/* units allocated for a new list */
+#define InitialUnits    256
+
+#define false 0
+#define true 1
+
+struct CskiplNodeStructure {
+    long long key;
+    int tie;
+    int level;
+    unsigned int forward[2];    /* level+1 used */
+};
+
+typedef struct CskiplNodeStructure *Node;
+
+/* 8 byte units of a node of level L */
+#define NodeUnits(L)    (2 + ((L)+2)/2)
+#define NodeAt(L,N)     ((Node) ((L)->units+(N)))
+
+struct CskiplStructure {
+    int level;                          /* highest level used */
+    unsigned int seed;                  /* state of the random generator */
+    unsigned int used;                  /* units used */
+    unsigned int size;                  /* units allocated */
+    CskiplNode freeNodes[MaxLevels];    /* deleted nodes by level, linked by forward[0] */
+    long long *units;                   /* the header is the node 0 */
+};
+
+
+static void *reallocate(void *p, size_t size)
+{
+    if( (p = realloc(p, size)) == NULL ) {
+        fprintf(stderr, "Insufficient memory available");
+        exit(-1);
+    }
+    return p;
+}
+
+/* the array of units may move */
+static CskiplNode newNode(Cskipl l, int level)
+{
+    CskiplNode n;
+    unsigned int units = NodeUnits(level);
+
+    if( (n=l->freeNodes[level]) != 0 ) {
+        l->freeNodes[level] = NodeAt(l, n)->forward[0];
+        return n;
+    }
+    if( l->used+units > l->size ) {
+        if( l->size > UINT_MAX/2 ) {
+            fprintf(stderr, "Too many nodes in a compact skip list\n");
+            exit(-1);
+        }
+        l->size *= 2;
+        l->units = reallocate(l->units, l->size*sizeof(long long));
+    }
+    n = l->used;
+    l->used += units;
+    NodeAt(l, n)->level = level;
+    return n;
+}
+
+/* xorshift32, p=1/4 for each level */
+static int randomLevel(Cskipl l)
+{
+    unsigned int x = l->seed;
+    int level = 0;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    l->seed = x;
+    while( (x&3) == 0 && level < MaxLevels-1 ) {
+        level++;
+        x >>= 2;
+    }
+    return level;
+}
+
+/*
+ * update[k] is the last node of level k with a key less than 'key' (or the
+ * header). Returns update[0]
+ */
+static CskiplNode search(Cskipl l, SkiplKeyType key, CskiplNode update[])
+{
+    CskiplNode p, q;
+    int k;
+
+    p = 0;
+    for(k=l->level; k>=0; k--) {
+        while( (q=NodeAt(l, p)->forward[k]) != 0 && SKIPL_LESS(*NodeAt(l, q), key) )
+            p = q;
+        update[k] = p;
+    }
+    return p;
+}
+
+/* update[k] is the node before n in level k */
+static void unlinkNode(Cskipl l, CskiplNode n, CskiplNode update[])
+{
+    Node q = NodeAt(l, n);
+    int k;
+
+    for(k=0; k<=q->level; k++)
+        NodeAt(l, update[k])->forward[k] = q->forward[k];
+    q->forward[0] = l->freeNodes[q->level];
+    l->freeNodes[q->level] = n;
+    while( l->level > 0 && NodeAt(l, 0)->forward[l->level] == 0 )
+        l->level--;
+}
+
+
+Cskipl CskiplNew(void)
+{
+    Cskipl l;
+
+    if( (l=calloc(1, sizeof(struct CskiplStructure))) == NULL ) {
+        fprintf(stderr, "Insufficient memory available");
+        exit(-1);
+    }
+    l->seed = DefaultSeed;
+    l->size = InitialUnits;
+    l->units = reallocate(NULL, l->size*sizeof(long long));
+    l->used = NodeUnits(MaxLevels-1);
+    memset(l->units, 0, l->used*sizeof(long long));
+    NodeAt(l, 0)->level = MaxLevels-1;
+    return l;
+}
+
+void CskiplFree(Cskipl l)
+{
+    free(l->units);
+    free(l);
+}
+
+/* the copy only has room for the units used */
+Cskipl CskiplCopy(Cskipl l)
+{
+    Cskipl c;
+
+    c = reallocate(NULL, sizeof(struct CskiplStructure));
+    memcpy(c, l, sizeof(struct CskiplStructure));
+    c->size = l->used;
+    c->units = reallocate(NULL, c->size*sizeof(long long));
+    memcpy(c->units, l->units, c->size*sizeof(long long));
+    return c;
+}
+
+size_t CskiplBytes(Cskipl l)
+{
+    return sizeof(struct CskiplStructure) + l->size*sizeof(long long);
+}
+
+/* returns false if the key was already there. The node is stored in *nodePointer */
+int CskiplInsert(Cskipl l, SkiplKeyType key, CskiplNode *nodePointer)
+{
+    CskiplNode update[MaxLevels];
+    CskiplNode n;
+    Node q;
+    int k, level;
+
+    n = NodeAt(l, search(l, key, update))->forward[0];
+    if( n != 0 && SKIPL_EQUAL(*NodeAt(l, n), key) ) {
+        if( nodePointer != NULL )
+            *nodePointer = n;
+        return false;
+    }
+    level = randomLevel(l);
+    if( level > l->level ) {
+        for(k=l->level+1; k<=level; k++)
+            update[k] = 0;
+        l->level = level;
+    }
+    n = newNode(l, level);
+    q = NodeAt(l, n);
+    q->key = key.key;
+    q->tie = key.tie;
+    for(k=0; k<=level; k++) {
+        q->forward[k] = NodeAt(l, update[k])->forward[k];
+        NodeAt(l, update[k])->forward[k] = n;
+    }
+    if( nodePointer != NULL )
+        *nodePointer = n;
+    return true;
+}
+
+int CskiplDelete(Cskipl l, SkiplKeyType key)
+{
+    CskiplNode update[MaxLevels];
+    CskiplNode n;
+
+    n = NodeAt(l, search(l, key, update))->forward[0];
+    if( n == 0 || !SKIPL_EQUAL(*NodeAt(l, n), key) )
+        return false;
+    unlinkNode(l, n, update);
+    return true;
+}
+
+void CskiplDeleteNode(Cskipl l, CskiplNode n)
+{
+    CskiplDelete(l, CskiplGetKey(l, n));
+}
+
+/* the first node has the header before it in all its levels */
+int CskiplPopMin(Cskipl l, SkiplKeyType *keyPointer)
+{
+    CskiplNode update[MaxLevels];
+    CskiplNode n;
+
+    if( (n=NodeAt(l, 0)->forward[0]) == 0 )
+        return false;
+    *keyPointer = CskiplGetKey(l, n);
+    memset(update, 0, sizeof(update));
+    unlinkNode(l, n, update);
+    return true;
+}
+
+CskiplNode CskiplHead(Cskipl l)
+{
+    return NodeAt(l, 0)->forward[0];
+}
+
+CskiplNode CskiplNext(Cskipl l, CskiplNode n)
+{
+    return NodeAt(l, n)->forward[0];
+}
+
+SkiplKeyType CskiplGetKey(Cskipl l, CskiplNode n)
+{
+    SkiplKeyType key;
+
+    key.key = NodeAt(l, n)->key;
+    key.tie = NodeAt(l, n)->tie;
+    return key;
+}
+
+int CskiplIsEmpty(Cskipl l)
+{
+    return NodeAt(l, 0)->forward[0] == 0;
+}
+
+
+#ifdef CSKIPL_TEST
+/* random inserts and deletes checked against an array of flags, and a copy */
+#define sampleSize 5000
+
+static int present[sampleSize];
+
+static int checkList(Cskipl l)
+{
+    CskiplNode n;
+    SkiplKeyType key, last;
+    int k, errors = 0;
+
+    for(k=0; k<sampleSize; k++)
+        errors -= present[k];
+    last.key = -1;
+    last.tie = 0;
+    for(n=CskiplHead(l); n!=0; n=CskiplNext(l, n)) {
+        key = CskiplGetKey(l, n);
+        if( !SKIPL_LESS(last, key) || !present[key.key] )
+            errors++;
+        last = key;
+        errors++;
+    }
+    return errors;
+}
+
+int main(void)
+{
+    Cskipl l, c;
+    CskiplNode n;
+    SkiplKeyType key;
+    int i, k, count, errors = 0;
+
+    l = CskiplNew();
+    srand(1);
+    for(i=0; i<20*sampleSize; i++) {
+        k = rand()%sampleSize;
+        key.key = k;
+        key.tie = k%7;
+        if( rand()%3 ) {
+            if( CskiplInsert(l, key, &n) == present[k] || CskiplGetKey(l, n).key != k )
+                errors++;
+            present[k] = 1;
+        } else if( rand()%2 && present[k] ) {
+            CskiplInsert(l, key, &n);
+            CskiplDeleteNode(l, n);
+            present[k] = 0;
+        } else {
+            if( CskiplDelete(l, key) != present[k] )
+                errors++;
+            present[k] = 0;
+        }
+    }
+    errors += checkList(l);
+    c = CskiplCopy(l);
+    CskiplFree(l);
+    errors += checkList(c);
+    for(count=0; CskiplPopMin(c, &key); count++) {
+        if( !present[key.key] )
+            errors++;
+        present[key.key] = 0;
+    }
+    for(k=0; k<sampleSize; k++)
+        errors += present[k];
+    printf("%d nodes in %lu bytes, %d errors\n", count, (unsigned long) CskiplBytes(c), errors);
+    CskiplFree(c);
+    return errors != 0;
+}
+#endif /* CSKIPL_TEST */
@@ -0,0 +1,38 @@
+/******************************************************************************
+ *                  CSKIPL.H
+ * Compact skip list interface
+ *
+ * The nodes of a list are kept in one growable array and linked by 32 bit
+ * indexes into it. A node only has the key: its tie is the index of the
+ * entry (a task) in some table of the caller, so no value is stored. As the
+ * nodes have no pointers, a list is copied with two memcpy (CskiplCopy),
+ * and its nodes keep their indexes in the copy.
+ *
+ * A CskiplNode is the index of a node, 0 for none. It stays valid until the
+ * node is deleted, but the memory of the nodes may move when one is
+ * inserted, so the key of a node is read with CskiplGetKey.
+ *****************************************************************************/
+#ifndef CSKIPL_H
+#define CSKIPL_H
+
+#include <stddef.h> /* for size_t */
+#include "skipl.h"
+
+typedef struct CskiplStructure *Cskipl;
+typedef unsigned int CskiplNode;
+
+Cskipl CskiplNew(void);
+void CskiplFree(Cskipl l);
+Cskipl CskiplCopy(Cskipl l);
+size_t CskiplBytes(Cskipl l);
+int  CskiplInsert(Cskipl l, SkiplKeyType key, CskiplNode *nodePointer);
+int  CskiplDelete(Cskipl l, SkiplKeyType key);
+void CskiplDeleteNode(Cskipl l, CskiplNode n);
+int  CskiplPopMin(Cskipl l, SkiplKeyType *keyPointer);
+
+CskiplNode CskiplHead(Cskipl l);
+CskiplNode CskiplNext(Cskipl l, CskiplNode n);
+SkiplKeyType CskiplGetKey(Cskipl l, CskiplNode n);
+int CskiplIsEmpty(Cskipl l);
+
+#endif /* CSKIPL_H */
@@ -5,21 +5,33 @@
  *    the lcd of many integers.
  *
  * Routines:
- *   int gcd(a,b) returns the gcd using Euclydean algorithm
+ *   long long gcd(a,b) returns the gcd using Euclydean algorithm
  *
- *   int lcd(a,b) returns the lcm using the property a*b=lcm*gcd
+ *   long long lcd(a,b) returns the lcm using the property a*b=lcm*gcd
+ *                (as a/gcd*b, so the intermediate value is not larger
+ *                than the result)
  *
- *   void lcm_gcd(int a, int b, int *plcm, *pgcd) calculates both
- *                but avoids to duplicate the gcd calculation
+ *   void lcm_gcd(long long a, long long b, long long *plcm, *pgcd)
+ *                calculates both but avoids to duplicate the gcd calculation
  *
- *   int lcmv1(int v[], int n) calculates the lcm of the n integers 
- *                in v using gcd of pair of numbers (FASTER!!!)
+ *   long long lcmv1(long long v[], int n) calculates the lcm of the n
+ *                integers in v using gcd of pair of numbers (FASTER!!!)
  *
- *   int lcmv2(int v[], int n) calculates the lcm of the n integers
- *                in v using an algorithm that add the original number
- *                to the smallest number in v
+ *   long long lcmv2(long long v[], int n) calculates the lcm of the n
+ *                integers in v using an algorithm that add the original
+ *                number to the smallest number in v
  *
  *   lcmv is an alias to lcmv1
+ *
+ *   All of them work on 64-bit integers (Hans, 2026)
+ *
+ *   long long bgcd(a,b) returns the gcd using the binary algorithm
+ *
+ *   int lcmvlimit(long long v[], int n, long long limit, long long *l)
+ *                lcm of the n integers in v with overflow detection
+ *
+ *   int lcmvprimes(long long v[], int n, long long limit, long long *l)
+ *                the same, by prime factorization
  * 
  *   Author: Hans (22/06/2011)
  *
@@ -35,6 +47,7 @@
 
 
 #include<stdlib.h>
+#include<limits.h>
 #ifdef DEBUG
 #include<stdio.h>
 #endif
@@ -48,8 +61,8 @@
 
 #include "lcmgcd.h"
 
-int gcd(int a, int b)  {
-int c;
+long long gcd(long long a, long long b)  {
+long long c;
 
 	if( a < 0 ) a = -a;
 	if( b < 0 ) b = -b;
@@ -65,31 +78,32 @@ int c;
 	return b;
 }
 
-int lcm(int a, int b) {
-int c;
+long long lcm(long long a, long long b) {
+long long c;
 
 	c = gcd(a,b);
 	if( c )
-		return a*b/c;
+		return a/c*b;
 	else
 		return 0;
 }
 
-void lcm_gcd( int a, int b, int *l, int *g) {
+void lcm_gcd( long long a, long long b, long long *l, long long *g) {
 	*l = *g = 0;
-	int c = gcd(a,b);
+	long long c = gcd(a,b);
 	*g = c;
 	if( c )
-		*l = a*b/c;
+		*l = a/c*b;
 }
 
-int lcmv1(int *v, int n) {
+long long lcmv1(long long *v, int n) {
 #ifdef USE_ALLOCA
-int *t = alloca(n*sizeof(int));
+long long *t = alloca(n*sizeof(long long));
 #else
-int *t = calloc(n,sizeof(int));
+long long *t = calloc(n,sizeof(long long));
 #endif
-int i,j,k,x;
+int i,j,k;
+long long x;
 
 	if( t == NULL ) {
 		return 0;
@@ -99,7 +113,7 @@ int i,j,k,x;
 	k = n;
 	while(k>1) {
 #ifdef DEBUG
-        for(i=0;i<n;i++) printf("%d ",t[i]); putchar('\n');
+        for(i=0;i<n;i++) printf("%lld ",t[i]); putchar('\n');
 #endif
 		j = 0;
 		i = 0;
@@ -118,13 +132,14 @@ int i,j,k,x;
 	return x;
 }
 
-int lcmv2(int *v, int n) {
+long long lcmv2(long long *v, int n) {
 #ifdef USE_ALLOCA
-int *t = alloca(n*sizeof(int));
+long long *t = alloca(n*sizeof(long long));
 #else
-int *t = calloc(n,sizeof(int));
+long long *t = calloc(n,sizeof(long long));
 #endif
-int j,k,min,cnt;
+int j,k,cnt;
+long long min;
 #ifdef DEBUG
 int i;
 #endif
@@ -151,7 +166,7 @@ int i;
 			j++;
 		}
 #ifdef DEBUG        
-        for(i=0;i<n;i++) printf("%d ",t[i]);putchar('\n');
+        for(i=0;i<n;i++) printf("%lld ",t[i]);putchar('\n');
 #endif
 
 		if( cnt == n ) 
@@ -165,29 +180,156 @@ int i;
 	return min;
 }
 
-int lcmv(int *v, int n) {
+long long lcmv(long long *v, int n) {
     return lcmv1(v,n);
 }
 
+long long bgcd(long long a, long long b) {
+int shift;
+long long c;
+
+	if( a < 0 ) a = -a;
+	if( b < 0 ) b = -b;
+	if( a == 0 ) return b;
+	if( b == 0 ) return a;
+
+	/* common factors of 2 */
+	shift = __builtin_ctzll(a|b);
+	a >>= __builtin_ctzll(a);
+	do {
+		/* a is odd: the factors of 2 in b are not common */
+		b >>= __builtin_ctzll(b);
+		if( a > b ) { c=a; a=b; b=c; }
+		b -= a;
+	} while( b != 0 );
+	return a << shift;
+}
+
+int lcmvlimit(long long *v, int n, long long limit, long long *l) {
+long long x, a;
+int i;
+
+	if( limit <= 0 ) limit = LLONG_MAX;
+	x = 1;
+	for(i=0;i<n;i++) {
+		if( v[i] <= 0 )
+			return LCM_INVALID;
+		/* lcm(x,v[i]) = x*(v[i]/gcd) and it must not exceed limit */
+		a = v[i]/bgcd(x,v[i]);
+		if( x > limit/a )
+			return LCM_TOOLARGE;
+		x *= a;
+	}
+	*l = x;
+	return LCM_OK;
+}
+
+/* a prime power found in one of the integers */
+struct primepower_s {
+	long long p;
+	long long power;
+};
+
+static int cmpll(const void *a, const void *b) {
+long long x = *(const long long *) a, y = *(const long long *) b;
+
+	return (x > y) - (x < y);
+}
+
+/* by prime, then by increasing power */
+static int cmppower(const void *a, const void *b) {
+const struct primepower_s *x = a, *y = b;
+
+	if( x->p != y->p )
+		return (x->p > y->p) - (x->p < y->p);
+	return (x->power > y->power) - (x->power < y->power);
+}
+
+int lcmvprimes(long long *v, int n, long long limit, long long *l) {
+long long *t, a, p, q, x;
+struct primepower_s *f;
+int i, m, k, rc;
+
+	if( limit <= 0 ) limit = LLONG_MAX;
+	if( n == 0 ) {
+		*l = 1;
+		return LCM_OK;
+	}
+	/* only the distinct integers matter */
+	t = malloc(n*sizeof(long long));
+	/* an integer has at most 63 prime factors */
+	f = malloc(64*n*sizeof(struct primepower_s));
+	if( t == NULL || f == NULL ) {
+		free(t);
+		free(f);
+		return LCM_INVALID;
+	}
+	for(i=0;i<n;i++) t[i] = v[i];
+	qsort(t, n, sizeof(long long), cmpll);
+	rc = LCM_OK;
+	if( t[0] <= 0 )
+		rc = LCM_INVALID;
+
+	/* factor them by trial division */
+	k = 0;
+	for(i=0;i<n && rc==LCM_OK;i++) {
+		if( i > 0 && t[i] == t[i-1] )
+			continue;
+		a = t[i];
+		for(p=2; p<=a/p; p+=(p==2)?1:2) {
+			if( a%p != 0 )
+				continue;
+			q = 1;
+			while( a%p == 0 ) {
+				a /= p;
+				q *= p;
+			}
+			f[k].p = p;
+			f[k++].power = q;
+		}
+		if( a > 1 ) {
+			f[k].p = a;
+			f[k++].power = a;
+		}
+	}
+
+	/* multiply the highest power of each prime */
+	qsort(f, k, sizeof(struct primepower_s), cmppower);
+	x = 1;
+	for(m=0;m<k && rc==LCM_OK;m++) {
+		if( m+1 < k && f[m+1].p == f[m].p )
+			continue;
+		if( x > limit/f[m].power )
+			rc = LCM_TOOLARGE;
+		else
+			x *= f[m].power;
+	}
+	free(f);
+	free(t);
+	if( rc == LCM_OK )
+		*l = x;
+	return rc;
+}
+
 	
 #if defined(TEST) || defined(TESTV)
 #include<stdio.h>
 
 #ifdef TEST
 int main(int argc,char *argv[]) {
-int a,b,l,g;
+long long a,b,l,g;
 char line[255];
 
 	while( !feof(stdin) ) {
 		fgets(line,254,stdin);
-		int rc = sscanf(line,"%d %d",&a,&b);	
+		int rc = sscanf(line,"%lld %lld",&a,&b);	
 		if( rc == 0 )
 			break;
 		if( rc != 2 )
 			continue;
 		l = lcm(a,b);
 		g = gcd(a,b);
-		printf("gdc(%1d,%1d)=%d  lcm(%d,%d)=%d\n",a,b,g,a,b,l);
+		printf("gdc(%1lld,%1lld)=%lld  lcm(%lld,%lld)=%lld\n",a,b,g,a,b,l);
 	}
 	return 0;
 }
@@ -201,8 +343,9 @@ char line[255];
 
 int main(int argc,char *argv[]) {
 char line[255];
-int v[127];
-int n,x;
+long long v[127];
+long long x;
+int n;
 char *p;
 clock_t ti,tf;
 int i;
@@ -213,15 +356,23 @@ int i;
         n = 0;
         printf("lcm of ");
 		while(p) {
-			x = atoi(p);
+			x = atoll(p);
 			if( x ) {
 				v[n++] = x;
-                printf("%d ",x);
+                printf("%lld ",x);
             }
 			p = strtok(NULL," \t");
 		}
-		printf(" is %d",lcmv1(v,n));
-		printf(" (%d)\n",lcmv2(v,n));
+		printf(" is %lld",lcmv1(v,n));
+		printf(" (%lld)",lcmv2(v,n));
+		if( lcmvlimit(v,n,0,&x) == LCM_OK )
+			printf(" (%lld)",x);
+		else
+			printf(" (too large)");
+		if( lcmvprimes(v,n,0,&x) == LCM_OK )
+			printf(" (%lld)\n",x);
+		else
+			printf(" (too large)\n");
  
         printf("NTIMES=%d\n",NTIMES);
         ti = clock();
@@ -232,6 +383,14 @@ int i;
         for(i=0;i<NTIMES;i++) x = lcmv2(v,n);
         tf = clock();
         printf("tempo v2 = %f\n",(((double) (tf-ti))/CLOCKS_PER_SEC)/1000.0);
+        ti = clock();
+        for(i=0;i<NTIMES;i++) lcmvlimit(v,n,0,&x);
+        tf = clock();
+        printf("tempo limit = %f\n",(((double) (tf-ti))/CLOCKS_PER_SEC)/1000.0);
+        ti = clock();
+        for(i=0;i<NTIMES;i++) lcmvprimes(v,n,0,&x);
+        tf = clock();
+        printf("tempo primes = %f\n",(((double) (tf-ti))/CLOCKS_PER_SEC)/1000.0);
 	}
 	return 0;
 }
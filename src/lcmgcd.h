@@ -6,33 +6,58 @@
  *    the lcd of many integers.
  *
  * Routines:
- *   int gcd(a,b) returns the gcd using Euclydean algorithm
+ *   long long gcd(a,b) returns the gcd using Euclydean algorithm
  *
- *   int lcd(a,b) returns the lcm using the property a*b=lcm*gcd
+ *   long long lcd(a,b) returns the lcm using the property a*b=lcm*gcd
+ *                (as a/gcd*b, so the intermediate value is not larger
+ *                than the result)
  *
- *   void lcm_gcd(int a, int b, int *plcm, *pgcd) calculates both
- *                but avoids to duplicate the gcd calculation
+ *   void lcm_gcd(long long a, long long b, long long *plcm, *pgcd)
+ *                calculates both but avoids to duplicate the gcd calculation
  *
- *   int lcmv1(int v[], int n) calculates the lcm of the n integers 
- *                in v using gcd of pair of numbers (FASTER!!!)
+ *   long long lcmv1(long long v[], int n) calculates the lcm of the n
+ *                integers in v using gcd of pair of numbers (FASTER!!!)
  *
- *   int lcmv2(int v[], int n) calculates the lcm of the n integers
- *                in v using an algorithm that add the original number
- *                to the smallest number in v
+ *   long long lcmv2(long long v[], int n) calculates the lcm of the n
+ *                integers in v using an algorithm that add the original
+ *                number to the smallest number in v
  *
  *   lcmv is an alias to lcmv1
- * 
+ *
+ *   All of them work on 64-bit integers (Hans, 2026)
+ *
+ *   long long bgcd(a,b) returns the gcd using the binary algorithm
+ *                (Stein), with shifts and subtractions only
+ *
+ *   int lcmvlimit(long long v[], int n, long long limit, long long *l)
+ *                stores in *l the lcm of the n integers in v, reducing
+ *                them one by one with bgcd and checking for overflow.
+ *                Returns LCM_OK, LCM_TOOLARGE if the lcm is larger than
+ *                limit (no limit if it is 0) or LCM_INVALID if some
+ *                integer is not positive
+ *
+ *   int lcmvprimes(long long v[], int n, long long limit, long long *l)
+ *                the same, but it factors the distinct integers in v and
+ *                multiplies the highest power of each prime found
+ * * 
  *   Author: Hans (22/06/2011)
  *
  */
 
 
-int gcd(int a, int b);
-int lcm(int a, int b);
-void lcm_gcd(int a, int b, int *l, int *g);
-int lcmv1(int *v, int n);
-int lcmv2(int *v, int n);
-int lcmv(int *v, int n);
+long long gcd(long long a, long long b);
+long long lcm(long long a, long long b);
+void lcm_gcd(long long a, long long b, long long *l, long long *g);
+long long lcmv1(long long *v, int n);
+long long lcmv2(long long *v, int n);
+long long lcmv(long long *v, int n);
+long long bgcd(long long a, long long b);
+int lcmvlimit(long long *v, int n, long long limit, long long *l);
+int lcmvprimes(long long *v, int n, long long limit, long long *l);
+
+#define LCM_OK          0
+#define LCM_TOOLARGE    1
+#define LCM_INVALID     2
 
 
 #endif
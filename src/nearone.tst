@@ -0,0 +1,7 @@
+title Load just over 100%: the overload point is after the horizon
+tasks 2
+maxtime 1000
+;    Name  Criticality    Period    Execution time
+task A HIGH 49999 29545
+task B LOW 50021 20463
+end
@@ -0,0 +1,6 @@
+title Offsets and jitter
+tasks 3
+task A  HIGH  6  2 offset=1
+task B  HIGH  8  2 offset=3 jitter=2
+task Task_C  LOW  12  3 jitter=1
+end
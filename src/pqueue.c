@@ -0,0 +1,944 @@
+/*
+ * Priority queues with selectable implementation
+ *
+ * See pqueue.h
+ *
+ * Each kind of queue has a table of operations. The skip list ones just
+ * call the Skipl routines. The heaps keep, for each tie, where its entry is
+ * (an index in the d-ary heap, a node in the pairing heap), so an entry is
+ * deleted without searching for it. A handle is a node of the skip list or
+ * the pairing heap, but the entries of the d-ary heap move, so its handles
+ * are the ties (plus one, to never be NULL).
+ *
+ * The entries of the unrolled skip list (see uskipl.h) move too, and it has
+ * no index by tie, so its handles are also ties: the key of each one is
+ * kept and the entry is deleted by key.
+ *
+ * The compact skip list (see cskipl.h) only keeps the keys, so the value
+ * of each tie is kept here, and its nodes are indexes: the entry given by
+ * PQueueHead and PQueueNext is a copy, in the queue, of the one visited.
+ * Its handles are the indexes of the nodes.
+ *
+ * The typed skip list is generated by tskipl.h for the keys and values of
+ * a queue, with the comparison SKIPL_LESS expanded in its searches.
+ *
+ * A heap is not sorted, so it is iterated in key order with a frontier: a
+ * small binary heap with the entries whose parent was already visited.
+ * The next entry is the least one in the frontier, and its children join
+ * the frontier when it is visited.
+ *
+ */
+
+#include <stdio.h>  /* for stderr */
+#include <stdlib.h> /* for malloc() */
+#include <string.h> /* for strcmp() */
+#include <stdint.h> /* for intptr_t */
+
+#ifdef DMALLOC
+#include "dmalloc.h"
+#endif
+
+#include "pqueue.h"
+#include "uskipl.h"
+#include "cskipl.h"
+#include "tskipl.h"
+
+/* number of children of a node of the d-ary heap */
+#define HeapArity 4
+/* nodes allocated at a time for a pairing heap */
+#define PairingChunkNodes 256
+
+/* handles of the d-ary heap */
+#define TieHandle(T)    ((PQueueHandle) (intptr_t) ((T)+1))
+#define HandleTie(H)    ((int) (intptr_t) (H) - 1)
+
+struct PairingNodeStructure {
+    struct PQueueEntryStructure e;      /* must be the first field */
+    struct PairingNodeStructure *child;     /* first child */
+    struct PairingNodeStructure *sibling;   /* next sibling */
+    struct PairingNodeStructure *prev;      /* previous sibling or parent */
+};
+
+typedef struct PairingNodeStructure *PairingNode;
+
+struct PairingChunkStructure {
+    struct PairingChunkStructure *next;
+    struct PairingNodeStructure nodes[PairingChunkNodes];
+};
+
+TSKIPL_DEFINE(TypedList, PQueueKeyType, PQueueValueType, SKIPL_LESS)
+
+struct PQueueOps {
+    void (*free)(PQueue q);
+    int (*insert)(PQueue q, PQueueKeyType key, PQueueValueType value);
+    PQueueHandle (*inserthandle)(PQueue q, PQueueKeyType key, PQueueValueType value);
+    void (*insertsorted)(PQueue q, struct PQueueEntryStructure e[], int n, PQueueHandle h[]);
+    int (*delete)(PQueue q, PQueueKeyType key);
+    void (*deletehandle)(PQueue q, PQueueHandle h);
+    int (*popmin)(PQueue q, PQueueKeyType *key, PQueueValueType *value);
+    int (*deleteupto)(PQueue q, PQueueKeyType key, PQueueCallback callback, void *arg);
+    PQueueNode (*head)(PQueue q);
+    PQueueNode (*next)(PQueue q, PQueueNode n);
+    int (*isempty)(PQueue q);
+};
+
+struct PQueueStructure {
+    const struct PQueueOps *ops;
+
+    /* skip list */
+    SkipList list;
+
+    /* d-ary heap */
+    struct PQueueEntryStructure *entries;
+    int count;                  /* entries in the heap */
+    int size;                   /* entries allocated */
+    int *pos;                   /* index of the entry of each tie (or -1) */
+
+    /* pairing heap */
+    PairingNode root;
+    PairingNode *node;          /* node of each tie (or NULL) */
+    PairingNode freeNodes;      /* linked by sibling */
+    struct PairingChunkStructure *chunks;
+    int chunkUsed;              /* nodes used in the first chunk */
+
+    /* unrolled skip list */
+    Uskipl ulist;
+    PQueueKeyType *keyof;       /* key of the entry of each tie */
+
+    /* compact skip list */
+    Cskipl clist;
+    PQueueValueType *valueof;   /* value of the entry of each tie */
+    struct PQueueEntryStructure cursor; /* copy of the entry being visited */
+    CskiplNode cursornode;
+
+    /* typed skip list */
+    TypedList tlist;
+
+    int nties;                  /* size of pos, node, keyof and valueof */
+
+    /* iteration of the heaps */
+    PQueueNode *frontier;
+    int nfrontier;
+    int sizefrontier;
+};
+
+static void *reallocate(void *p, size_t size)
+{
+    if( (p = realloc(p, size)) == NULL ) {
+        fprintf(stderr, "Insufficient memory available");
+        exit(-1);
+    }
+    return p;
+}
+
+/* the position arrays must have room for 'tie' */
+static void growties(PQueue q, int tie)
+{
+    int i, n;
+
+    if( tie < 0 ) {
+        fprintf(stderr, "Negative tie in a heap\n");
+        exit(-1);
+    }
+    if( tie < q->nties )
+        return;
+    n = (2*q->nties > tie+1)? 2*q->nties : tie+1;
+    if( n < 64 ) n = 64;
+    q->pos = reallocate(q->pos, n*sizeof(int));
+    q->node = reallocate(q->node, n*sizeof(PairingNode));
+    q->keyof = reallocate(q->keyof, n*sizeof(PQueueKeyType));
+    q->valueof = reallocate(q->valueof, n*sizeof(PQueueValueType));
+    for(i=q->nties;i<n;i++) {
+        q->pos[i] = -1;
+        q->node[i] = NULL;
+    }
+    q->nties = n;
+}
+
+/*
+ * Frontier: binary heap of entries
+ */
+static void frontierpush(PQueue q, PQueueNode n)
+{
+    int i, parent;
+
+    if( q->nfrontier == q->sizefrontier ) {
+        q->sizefrontier = q->sizefrontier? 2*q->sizefrontier : 64;
+        q->frontier = reallocate(q->frontier, q->sizefrontier*sizeof(PQueueNode));
+    }
+    i = q->nfrontier++;
+    while( i > 0 && SKIPL_LESS(n->key, q->frontier[parent=(i-1)/2]->key) ) {
+        q->frontier[i] = q->frontier[parent];
+        i = parent;
+    }
+    q->frontier[i] = n;
+}
+
+static PQueueNode frontierpop(PQueue q)
+{
+    PQueueNode first, last;
+    int i, c;
+
+    if( q->nfrontier == 0 )
+        return NULL;
+    first = q->frontier[0];
+    last = q->frontier[--q->nfrontier];
+    i = 0;
+    while( (c=2*i+1) < q->nfrontier ) {
+        if( c+1 < q->nfrontier && SKIPL_LESS(q->frontier[c+1]->key, q->frontier[c]->key) )
+            c++;
+        if( !SKIPL_LESS(q->frontier[c]->key, last->key) )
+            break;
+        q->frontier[i] = q->frontier[c];
+        i = c;
+    }
+    q->frontier[i] = last;
+    return first;
+}
+
+/*
+ * the heaps gain nothing from the order of a batch: insert one at a time
+ */
+static void insertsorted(PQueue q, struct PQueueEntryStructure e[], int n, PQueueHandle h[])
+{
+    int i;
+
+    for(i=0;i<n;i++) {
+        if( h != NULL )
+            h[i] = (q->ops->inserthandle)(q, e[i].key, e[i].value);
+        else
+            (q->ops->insert)(q, e[i].key, e[i].value);
+    }
+}
+
+/* the heaps just pop the entries up to the key */
+static int deleteupto(PQueue q, PQueueKeyType key, PQueueCallback callback, void *arg)
+{
+    PQueueNode n;
+    PQueueKeyType k;
+    PQueueValueType v;
+    int count = 0;
+
+    while( (n=(q->ops->head)(q)) != NULL && !SKIPL_LESS(key, n->key) ) {
+        (q->ops->popmin)(q, &k, &v);
+        if( callback != NULL )
+            (*callback)(k, v, arg);
+        count++;
+    }
+    return count;
+}
+
+/*
+ * Skip list
+ */
+static void skiplfree(PQueue q)
+{
+    SkiplFree(q->list);
+}
+
+static int skiplinsert(PQueue q, PQueueKeyType key, PQueueValueType value)
+{
+    return SkiplInsert(q->list, key, value);
+}
+
+static PQueueHandle skiplinserthandle(PQueue q, PQueueKeyType key, PQueueValueType value)
+{
+    return SkiplInsertNode(q->list, key, value);
+}
+
+/* the entries have the layout of SkiplEntryType and the handles are nodes */
+static void skiplinsertsorted(PQueue q, struct PQueueEntryStructure e[], int n, PQueueHandle h[])
+{
+    SkiplInsertSorted(q->list, (SkiplEntryType *) e, n, (SkiplNode *) h);
+}
+
+static int skipldelete(PQueue q, PQueueKeyType key)
+{
+    return SkiplDelete(q->list, key);
+}
+
+static void skipldeletehandle(PQueue q, PQueueHandle h)
+{
+    SkiplDeleteNode(q->list, h);
+}
+
+static int skiplpopmin(PQueue q, PQueueKeyType *key, PQueueValueType *value)
+{
+    return SkiplPopMin(q->list, key, value);
+}
+
+static int skipldeleteupto(PQueue q, PQueueKeyType key, PQueueCallback callback, void *arg)
+{
+    return SkiplDeleteUpTo(q->list, key, callback, arg);
+}
+
+/* the skip list nodes also begin with the key and the value */
+static PQueueNode skiplhead(PQueue q)
+{
+    return (PQueueNode) SkiplHead(q->list);
+}
+
+static PQueueNode skiplnext(PQueue q, PQueueNode n)
+{
+    return (PQueueNode) SkiplNext((SkiplNode) n);
+}
+
+static int skiplisempty(PQueue q)
+{
+    return SkiplIsEmpty(q->list);
+}
+
+static const struct PQueueOps skiplops = {
+    skiplfree, skiplinsert, skiplinserthandle, skiplinsertsorted,
+    skipldelete, skipldeletehandle,
+    skiplpopmin, skipldeleteupto, skiplhead, skiplnext, skiplisempty
+};
+
+/*
+ * d-ary heap
+ */
+
+/* put the entry e at index i */
+static void heapplace(PQueue q, int i, struct PQueueEntryStructure *e)
+{
+    q->entries[i] = *e;
+    q->pos[e->key.tie] = i;
+}
+
+static void siftup(PQueue q, int i)
+{
+    struct PQueueEntryStructure e = q->entries[i];
+    int parent;
+
+    while( i > 0 ) {
+        parent = (i-1)/HeapArity;
+        if( !SKIPL_LESS(e.key, q->entries[parent].key) )
+            break;
+        heapplace(q, i, q->entries+parent);
+        i = parent;
+    }
+    heapplace(q, i, &e);
+}
+
+static void siftdown(PQueue q, int i)
+{
+    struct PQueueEntryStructure e = q->entries[i];
+    int c, first, last, min;
+
+    while( (first = HeapArity*i+1) < q->count ) {
+        last = first+HeapArity;
+        if( last > q->count )
+            last = q->count;
+        min = first;
+        for(c=first+1;c<last;c++) {
+            if( SKIPL_LESS(q->entries[c].key, q->entries[min].key) )
+                min = c;
+        }
+        if( !SKIPL_LESS(q->entries[min].key, e.key) )
+            break;
+        heapplace(q, i, q->entries+min);
+        i = min;
+    }
+    heapplace(q, i, &e);
+}
+
+static void heapfree(PQueue q)
+{
+    free(q->entries);
+}
+
+static int heapinsert(PQueue q, PQueueKeyType key, PQueueValueType value)
+{
+    int i;
+
+    growties(q, key.tie);
+    if( (i=q->pos[key.tie]) >= 0 ) {
+        if( !SKIPL_EQUAL(q->entries[i].key, key) ) {
+            fprintf(stderr, "Two entries with the same tie in a heap\n");
+            exit(-1);
+        }
+        q->entries[i].value = value;
+        return 0;
+    }
+    if( q->count == q->size ) {
+        q->size = q->size? 2*q->size : 64;
+        q->entries = reallocate(q->entries, q->size*sizeof(struct PQueueEntryStructure));
+    }
+    i = q->count++;
+    q->entries[i].key = key;
+    q->entries[i].value = value;
+    siftup(q, i);
+    return 1;
+}
+
+static PQueueHandle heapinserthandle(PQueue q, PQueueKeyType key, PQueueValueType value)
+{
+    heapinsert(q, key, value);
+    return TieHandle(key.tie);
+}
+
+/* delete the entry at index i */
+static void heapremove(PQueue q, int i)
+{
+    q->pos[q->entries[i].key.tie] = -1;
+    if( i == --q->count )
+        return;
+    /* the last entry takes its place */
+    heapplace(q, i, q->entries+q->count);
+    if( i > 0 && SKIPL_LESS(q->entries[i].key, q->entries[(i-1)/HeapArity].key) )
+        siftup(q, i);
+    else
+        siftdown(q, i);
+}
+
+static int heapdelete(PQueue q, PQueueKeyType key)
+{
+    int i;
+
+    if( key.tie < 0 || key.tie >= q->nties || (i=q->pos[key.tie]) < 0
+        || !SKIPL_EQUAL(q->entries[i].key, key) )
+        return 0;
+    heapremove(q, i);
+    return 1;
+}
+
+static void heapdeletehandle(PQueue q, PQueueHandle h)
+{
+    heapremove(q, q->pos[HandleTie(h)]);
+}
+
+static int heappopmin(PQueue q, PQueueKeyType *key, PQueueValueType *value)
+{
+    if( q->count == 0 )
+        return 0;
+    *key = q->entries[0].key;
+    *value = q->entries[0].value;
+    heapremove(q, 0);
+    return 1;
+}
+
+static PQueueNode heaphead(PQueue q)
+{
+    q->nfrontier = 0;
+    return q->count? q->entries : NULL;
+}
+
+static PQueueNode heapnext(PQueue q, PQueueNode n)
+{
+    int i, c;
+
+    i = HeapArity*(n-q->entries)+1;
+    for(c=i;c<i+HeapArity && c<q->count;c++)
+        frontierpush(q, q->entries+c);
+    return frontierpop(q);
+}
+
+static int heapisempty(PQueue q)
+{
+    return q->count == 0;
+}
+
+static const struct PQueueOps heapops = {
+    heapfree, heapinsert, heapinserthandle, insertsorted, heapdelete, heapdeletehandle,
+    heappopmin, deleteupto, heaphead, heapnext, heapisempty
+};
+
+/*
+ * Pairing heap
+ */
+
+/* the root with the greater key becomes the first child of the other */
+static PairingNode meld(PairingNode a, PairingNode b)
+{
+    PairingNode c;
+
+    if( a == NULL ) return b;
+    if( b == NULL ) return a;
+    if( SKIPL_LESS(b->e.key, a->e.key) ) { c=a; a=b; b=c; }
+    b->prev = a;
+    b->sibling = a->child;
+    if( a->child )
+        a->child->prev = b;
+    a->child = b;
+    a->sibling = a->prev = NULL;
+    return a;
+}
+
+/*
+ * two pass merge of the list of siblings beginning with 'first': they are
+ * melded in pairs from left to right and then the pairs from right to left
+ */
+static PairingNode mergepairs(PairingNode first)
+{
+    PairingNode a, b, stack, result;
+
+    stack = NULL;
+    while( first != NULL ) {
+        a = first;
+        b = a->sibling;
+        first = b? b->sibling : NULL;
+        a->sibling = a->prev = NULL;
+        if( b ) {
+            b->sibling = b->prev = NULL;
+            a = meld(a, b);
+        }
+        a->sibling = stack;
+        stack = a;
+    }
+    result = NULL;
+    while( stack != NULL ) {
+        a = stack;
+        stack = a->sibling;
+        a->sibling = NULL;
+        result = meld(result, a);
+    }
+    return result;
+}
+
+static PairingNode newpairingnode(PQueue q)
+{
+    struct PairingChunkStructure *c;
+    PairingNode n;
+
+    if( (n=q->freeNodes) != NULL ) {
+        q->freeNodes = n->sibling;
+        return n;
+    }
+    if( q->chunks == NULL || q->chunkUsed == PairingChunkNodes ) {
+        c = reallocate(NULL, sizeof(struct PairingChunkStructure));
+        c->next = q->chunks;
+        q->chunks = c;
+        q->chunkUsed = 0;
+    }
+    return q->chunks->nodes+q->chunkUsed++;
+}
+
+static void pairingfree(PQueue q)
+{
+    struct PairingChunkStructure *c;
+
+    while( (c=q->chunks) != NULL ) {
+        q->chunks = c->next;
+        free(c);
+    }
+}
+
+/* the node with the key is stored in *node. Returns 0 if it was there */
+static int pairingadd(PQueue q, PQueueKeyType key, PQueueValueType value,
+    PairingNode *node)
+{
+    PairingNode n;
+
+    growties(q, key.tie);
+    if( (n=*node=q->node[key.tie]) != NULL ) {
+        if( !SKIPL_EQUAL(n->e.key, key) ) {
+            fprintf(stderr, "Two entries with the same tie in a heap\n");
+            exit(-1);
+        }
+        n->e.value = value;
+        return 0;
+    }
+    n = *node = q->node[key.tie] = newpairingnode(q);
+    n->e.key = key;
+    n->e.value = value;
+    n->child = n->sibling = n->prev = NULL;
+    q->root = meld(q->root, n);
+    return 1;
+}
+
+static int pairinginsert(PQueue q, PQueueKeyType key, PQueueValueType value)
+{
+    PairingNode n;
+
+    return pairingadd(q, key, value, &n);
+}
+
+static PQueueHandle pairinginserthandle(PQueue q, PQueueKeyType key, PQueueValueType value)
+{
+    PairingNode n;
+
+    pairingadd(q, key, value, &n);
+    return n;
+}
+
+static void pairingremove(PQueue q, PairingNode n)
+{
+    q->node[n->e.key.tie] = NULL;
+    if( n == q->root ) {
+        q->root = mergepairs(n->child);
+    } else {
+        /* cut the subtree of n and meld its children with the rest */
+        if( n->prev->child == n )
+            n->prev->child = n->sibling;
+        else
+            n->prev->sibling = n->sibling;
+        if( n->sibling )
+            n->sibling->prev = n->prev;
+        q->root = meld(q->root, mergepairs(n->child));
+    }
+    n->sibling = q->freeNodes;
+    q->freeNodes = n;
+}
+
+static int pairingdelete(PQueue q, PQueueKeyType key)
+{
+    PairingNode n;
+
+    if( key.tie < 0 || key.tie >= q->nties || (n=q->node[key.tie]) == NULL
+        || !SKIPL_EQUAL(n->e.key, key) )
+        return 0;
+    pairingremove(q, n);
+    return 1;
+}
+
+static void pairingdeletehandle(PQueue q, PQueueHandle h)
+{
+    pairingremove(q, h);
+}
+
+static int pairingpopmin(PQueue q, PQueueKeyType *key, PQueueValueType *value)
+{
+    if( q->root == NULL )
+        return 0;
+    *key = q->root->e.key;
+    *value = q->root->e.value;
+    pairingremove(q, q->root);
+    return 1;
+}
+
+static PQueueNode pairinghead(PQueue q)
+{
+    q->nfrontier = 0;
+    return q->root? &q->root->e : NULL;
+}
+
+static PQueueNode pairingnext(PQueue q, PQueueNode n)
+{
+    PairingNode c;
+
+    for(c=((PairingNode) n)->child; c!=NULL; c=c->sibling)
+        frontierpush(q, &c->e);
+    return frontierpop(q);
+}
+
+static int pairingisempty(PQueue q)
+{
+    return q->root == NULL;
+}
+
+static const struct PQueueOps pairingops = {
+    pairingfree, pairinginsert, pairinginserthandle, insertsorted, pairingdelete,
+    pairingdeletehandle, pairingpopmin, deleteupto, pairinghead, pairingnext,
+    pairingisempty
+};
+
+/*
+ * Unrolled skip list
+ */
+static void unrolledfree(PQueue q)
+{
+    UskiplFree(q->ulist);
+}
+
+static int unrolledinsert(PQueue q, PQueueKeyType key, PQueueValueType value)
+{
+    return UskiplInsert(q->ulist, key, value);
+}
+
+static PQueueHandle unrolledinserthandle(PQueue q, PQueueKeyType key, PQueueValueType value)
+{
+    growties(q, key.tie);
+    q->keyof[key.tie] = key;
+    UskiplInsert(q->ulist, key, value);
+    return TieHandle(key.tie);
+}
+
+static int unrolleddelete(PQueue q, PQueueKeyType key)
+{
+    return UskiplDelete(q->ulist, key);
+}
+
+static void unrolleddeletehandle(PQueue q, PQueueHandle h)
+{
+    UskiplDelete(q->ulist, q->keyof[HandleTie(h)]);
+}
+
+static int unrolledpopmin(PQueue q, PQueueKeyType *key, PQueueValueType *value)
+{
+    return UskiplPopMin(q->ulist, key, value);
+}
+
+static int unrolleddeleteupto(PQueue q, PQueueKeyType key, PQueueCallback callback, void *arg)
+{
+    return UskiplDeleteUpTo(q->ulist, key, callback, arg);
+}
+
+/* the entries of the blocks have the layout of a PQueue entry */
+static PQueueNode unrolledhead(PQueue q)
+{
+    return (PQueueNode) UskiplHead(q->ulist);
+}
+
+static PQueueNode unrollednext(PQueue q, PQueueNode n)
+{
+    return (PQueueNode) UskiplNext((UskiplNode) n);
+}
+
+static int unrolledisempty(PQueue q)
+{
+    return UskiplIsEmpty(q->ulist);
+}
+
+static const struct PQueueOps unrolledops = {
+    unrolledfree, unrolledinsert, unrolledinserthandle, insertsorted,
+    unrolleddelete, unrolleddeletehandle, unrolledpopmin, unrolleddeleteupto,
+    unrolledhead, unrollednext, unrolledisempty
+};
+
+/*
+ * Compact skip list
+ */
+static void compactfree(PQueue q)
+{
+    CskiplFree(q->clist);
+}
+
+static int compactinsert(PQueue q, PQueueKeyType key, PQueueValueType value)
+{
+    growties(q, key.tie);
+    q->valueof[key.tie] = value;
+    return CskiplInsert(q->clist, key, NULL);
+}
+
+static PQueueHandle compactinserthandle(PQueue q, PQueueKeyType key, PQueueValueType value)
+{
+    CskiplNode n;
+
+    growties(q, key.tie);
+    q->valueof[key.tie] = value;
+    CskiplInsert(q->clist, key, &n);
+    return (PQueueHandle) (intptr_t) n;
+}
+
+static int compactdelete(PQueue q, PQueueKeyType key)
+{
+    return CskiplDelete(q->clist, key);
+}
+
+static void compactdeletehandle(PQueue q, PQueueHandle h)
+{
+    CskiplDeleteNode(q->clist, (CskiplNode) (intptr_t) h);
+}
+
+static int compactpopmin(PQueue q, PQueueKeyType *key, PQueueValueType *value)
+{
+    if( !CskiplPopMin(q->clist, key) )
+        return 0;
+    *value = q->valueof[key->tie];
+    return 1;
+}
+
+/* the entry of node n is copied to the cursor */
+static PQueueNode compactvisit(PQueue q, CskiplNode n)
+{
+    if( (q->cursornode = n) == 0 )
+        return NULL;
+    q->cursor.key = CskiplGetKey(q->clist, n);
+    q->cursor.value = q->valueof[q->cursor.key.tie];
+    return &q->cursor;
+}
+
+static PQueueNode compacthead(PQueue q)
+{
+    return compactvisit(q, CskiplHead(q->clist));
+}
+
+static PQueueNode compactnext(PQueue q, PQueueNode n)
+{
+    return compactvisit(q, CskiplNext(q->clist, q->cursornode));
+}
+
+static int compactisempty(PQueue q)
+{
+    return CskiplIsEmpty(q->clist);
+}
+
+static const struct PQueueOps compactops = {
+    compactfree, compactinsert, compactinserthandle, insertsorted,
+    compactdelete, compactdeletehandle, compactpopmin, deleteupto,
+    compacthead, compactnext, compactisempty
+};
+
+/*
+ * Typed skip list
+ */
+static void typedfree(PQueue q)
+{
+    TypedListFree(q->tlist);
+}
+
+static int typedinsert(PQueue q, PQueueKeyType key, PQueueValueType value)
+{
+    return TypedListInsert(q->tlist, key, value);
+}
+
+static PQueueHandle typedinserthandle(PQueue q, PQueueKeyType key, PQueueValueType value)
+{
+    return TypedListInsertNode(q->tlist, key, value);
+}
+
+static int typeddelete(PQueue q, PQueueKeyType key)
+{
+    return TypedListDelete(q->tlist, key);
+}
+
+static void typeddeletehandle(PQueue q, PQueueHandle h)
+{
+    TypedListDeleteNode(q->tlist, h);
+}
+
+static int typedpopmin(PQueue q, PQueueKeyType *key, PQueueValueType *value)
+{
+    return TypedListPopMin(q->tlist, key, value);
+}
+
+/* the nodes begin with the key and the value */
+static PQueueNode typedhead(PQueue q)
+{
+    return (PQueueNode) TypedListHead(q->tlist);
+}
+
+static PQueueNode typednext(PQueue q, PQueueNode n)
+{
+    return (PQueueNode) TypedListNext((TypedListNode) n);
+}
+
+static int typedisempty(PQueue q)
+{
+    return TypedListIsEmpty(q->tlist);
+}
+
+static const struct PQueueOps typedops = {
+    typedfree, typedinsert, typedinserthandle, insertsorted,
+    typeddelete, typeddeletehandle, typedpopmin, deleteupto,
+    typedhead, typednext, typedisempty
+};
+
+/*
+ * Interface
+ */
+PQueue PQueueNew(int kind)
+{
+    PQueue q;
+
+    if( (q = calloc(1, sizeof(struct PQueueStructure))) == NULL ) {
+        fprintf(stderr, "Insufficient memory available");
+        exit(-1);
+    }
+    switch( kind ) {
+    case PQUEUE_HEAP:
+        q->ops = &heapops;
+        break;
+    case PQUEUE_PAIRING:
+        q->ops = &pairingops;
+        break;
+    case PQUEUE_UNROLLED:
+        q->ops = &unrolledops;
+        q->ulist = UskiplNew();
+        break;
+    case PQUEUE_COMPACT:
+        q->ops = &compactops;
+        q->clist = CskiplNew();
+        break;
+    case PQUEUE_TYPED:
+        q->ops = &typedops;
+        q->tlist = TypedListNew();
+        break;
+    default:
+        q->ops = &skiplops;
+        if( (q->list = SkiplNew()) == NULL ) {
+            fprintf(stderr, "Insufficient memory available");
+            exit(-1);
+        }
+        break;
+    }
+    return q;
+}
+
+void PQueueFree(PQueue q)
+{
+    (q->ops->free)(q);
+    free(q->pos);
+    free(q->node);
+    free(q->keyof);
+    free(q->valueof);
+    free(q->frontier);
+    free(q);
+}
+
+int PQueueInsert(PQueue q, PQueueKeyType key, PQueueValueType value)
+{
+    return (q->ops->insert)(q, key, value);
+}
+
+PQueueHandle PQueueInsertHandle(PQueue q, PQueueKeyType key, PQueueValueType value)
+{
+    return (q->ops->inserthandle)(q, key, value);
+}
+
+void PQueueInsertSorted(PQueue q, struct PQueueEntryStructure e[], int n, PQueueHandle h[])
+{
+    (q->ops->insertsorted)(q, e, n, h);
+}
+
+int PQueueDelete(PQueue q, PQueueKeyType key)
+{
+    return (q->ops->delete)(q, key);
+}
+
+void PQueueDeleteHandle(PQueue q, PQueueHandle h)
+{
+    (q->ops->deletehandle)(q, h);
+}
+
+int PQueuePopMin(PQueue q, PQueueKeyType *key, PQueueValueType *value)
+{
+    return (q->ops->popmin)(q, key, value);
+}
+
+int PQueueDeleteUpTo(PQueue q, PQueueKeyType key, PQueueCallback callback, void *arg)
+{
+    return (q->ops->deleteupto)(q, key, callback, arg);
+}
+
+PQueueNode PQueueHead(PQueue q)
+{
+    return (q->ops->head)(q);
+}
+
+PQueueNode PQueueNext(PQueue q, PQueueNode n)
+{
+    return (q->ops->next)(q, n);
+}
+
+int PQueueIsEmpty(PQueue q)
+{
+    return (q->ops->isempty)(q);
+}
+
+int PQueueKind(char *name)
+{
+    if( strcmp(name, "skipl") == 0 )
+        return PQUEUE_SKIPL;
+    if( strcmp(name, "heap") == 0 )
+        return PQUEUE_HEAP;
+    if( strcmp(name, "pairing") == 0 )
+        return PQUEUE_PAIRING;
+    if( strcmp(name, "unrolled") == 0 )
+        return PQUEUE_UNROLLED;
+    if( strcmp(name, "compact") == 0 )
+        return PQUEUE_COMPACT;
+    if( strcmp(name, "typed") == 0 )
+        return PQUEUE_TYPED;
+    return -1;
+}
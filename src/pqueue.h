@@ -0,0 +1,109 @@
+#ifndef PQUEUE_H
+#define PQUEUE_H
+/*
+ * Priority queues with selectable implementation
+ *
+ * The same interface is given by a skip list (see skipl.h), a d-ary
+ * implicit heap, a pairing heap, an unrolled skip list (uskipl.h), a
+ * compact skip list (cskipl.h) and a typed skip list generated for these
+ * keys and values (tskipl.h). The keys are the skip list ones, a
+ * (key,tie) pair, and they must be unique in a queue.
+ *
+ * The heaps find the entry to delete by its tie, so the ties of the keys in
+ * a heap must be small non negative integers (task ids) and no two entries
+ * in the same heap can have the same tie. The same goes for the handles of
+ * the unrolled skip list and for the compact one, that keeps a value per tie.
+ *
+ * Routines:
+ *   PQueue PQueueNew(int kind) returns an empty queue of the given kind
+ *                (PQUEUE_SKIPL, PQUEUE_HEAP, PQUEUE_PAIRING,
+ *                PQUEUE_UNROLLED, PQUEUE_COMPACT or PQUEUE_TYPED)
+ *
+ *   void PQueueFree(PQueue q) releases the queue and its entries
+ *
+ *   int PQueueInsert(PQueue q, key, value) inserts the entry. If the key
+ *                is already there, its value is replaced and it returns 0
+ *
+ *   PQueueHandle PQueueInsertHandle(PQueue q, key, value) inserts the
+ *                entry and returns a handle to it, valid until it is deleted
+ *
+ *   void PQueueInsertSorted(PQueue q, e[], int n, PQueueHandle h[]) inserts
+ *                the n entries of e, that must be in increasing key order.
+ *                The skip list does it in one pass. The handle of e[i] is
+ *                stored in h[i] if h is not NULL
+ *
+ *   int PQueueDelete(PQueue q, key) deletes the entry with the key.
+ *                Returns 0 if it was not found
+ *
+ *   void PQueueDeleteHandle(PQueue q, PQueueHandle h) deletes the entry of
+ *                the handle, without searching for it
+ *
+ *   int PQueuePopMin(PQueue q, &key, &value) deletes the entry with the
+ *                least key and stores its key and value. Returns 0 if empty
+ *
+ *   int PQueueDeleteUpTo(PQueue q, key, callback, arg) deletes all the
+ *                entries with keys up to the given one, in increasing order,
+ *                calling callback(key, value, arg) for each one (it must not
+ *                use the queue). Returns how many were deleted
+ *
+ *   PQueueNode PQueueHead(PQueue q) returns the entry with the least key
+ *                (NULL if empty)
+ *
+ *   PQueueNode PQueueNext(PQueue q, PQueueNode n) returns the entry after
+ *                n in increasing key order (NULL after the last). The heaps
+ *                and the compact skip list keep the state of the iteration
+ *                in the queue, so only one iteration per queue can be done
+ *                at a time, it must begin with PQueueHead and the queue can
+ *                not be changed during it
+ *
+ *   int PQueueIsEmpty(PQueue q)
+ *
+ *   PQueueGetKey(n) and PQueueGetValue(n) return the key and the value of
+ *                an entry
+ *
+ *   int PQueueKind(char *name) returns the kind with the name ("skipl",
+ *                "heap", "pairing", "unrolled", "compact" or "typed") or -1
+ *
+ */
+
+#include "skipl.h"
+
+typedef SkiplKeyType PQueueKeyType;
+typedef SkiplValueType PQueueValueType;
+
+/* all kinds of queue keep the key and the value at the start of an entry */
+struct PQueueEntryStructure {
+    PQueueKeyType key;
+    PQueueValueType value;
+};
+
+typedef struct PQueueEntryStructure *PQueueNode;
+typedef struct PQueueStructure *PQueue;
+typedef void *PQueueHandle;
+typedef SkiplCallback PQueueCallback;
+
+#define PQUEUE_SKIPL    0
+#define PQUEUE_HEAP     1
+#define PQUEUE_PAIRING  2
+#define PQUEUE_UNROLLED 3
+#define PQUEUE_COMPACT  4
+#define PQUEUE_TYPED    5
+
+PQueue PQueueNew(int kind);
+void PQueueFree(PQueue q);
+int  PQueueInsert(PQueue q, PQueueKeyType key, PQueueValueType value);
+PQueueHandle PQueueInsertHandle(PQueue q, PQueueKeyType key, PQueueValueType value);
+void PQueueInsertSorted(PQueue q, struct PQueueEntryStructure e[], int n, PQueueHandle h[]);
+int  PQueueDelete(PQueue q, PQueueKeyType key);
+void PQueueDeleteHandle(PQueue q, PQueueHandle h);
+int  PQueuePopMin(PQueue q, PQueueKeyType *key, PQueueValueType *value);
+int  PQueueDeleteUpTo(PQueue q, PQueueKeyType key, PQueueCallback callback, void *arg);
+PQueueNode PQueueHead(PQueue q);
+PQueueNode PQueueNext(PQueue q, PQueueNode n);
+int  PQueueIsEmpty(PQueue q);
+int  PQueueKind(char *name);
+
+#define PQueueGetKey(N)   ((N)->key)
+#define PQueueGetValue(N) ((N)->value)
+
+#endif
@@ -10,37 +10,66 @@ environment, under several real-time scheduling algorithms.  The objective is
 to obtain a timeline of the execution, and to show if tasks meet their
 deadlines or not.
 
-    Tasks are assumed to be hard real-time, preemptive, periodic, with
-deadline equal to the next instance's arrival time, and independent (they do
-not need to syncronize with others in order to execute).  They also do not
-suspend its execution voluntarily.  All tasks start execution at the same
-time in the simulation.
+    Tasks are assumed to be hard real-time, preemptive, periodic and
+independent (they do not need to syncronize with others in order to
+execute).  They also do not suspend its execution voluntarily.  Each task
+has a period and an execution time, and optionally an offset (the release
+of its first instance), a release jitter and a relative deadline, which is
+the period by default and may be shorter.  Without offsets nor jitter all
+tasks start execution at the same time and one hyperperiod is simulated
+(or the maxtime given); with them the simulation stops as soon as the state
+repeats.
 
     Available algorithms for scheduling are Rate Monotonic (RM),
-Earliest-Deadline-First (EDF), Least-Laxity-First (LLF) and
-Maximum-Urgency-First (MUF), selected in the command line.  Also selected in
-the command line is the configuration file, containing the task set
-description and the system parameters.
+Earliest-Deadline-First (EDF), Least-Laxity-First (LLF), Modified
+Least-Laxity-First (MLLF) and Maximum-Urgency-First (MUF), selected in the
+command line.  Also selected in the command line are the configuration
+files, containing the task set description and the system parameters.
+RM and EDF are also checked analytically (response time analysis and
+processor demand analysis), and with -q the verdict comes from the
+cheapest test that decides it.
 
 Usage:
-    rtalgs -[e|E|l|L|m|M|r|R] <testvect.name>
+    rtalgs { [-r] [-e] [-l] [-L] [-m] } [-a] [-b] [-d] [-j <threads>]
+           [-k <queue>] [-p <budget>] [-q] [-s <sweep>] [-t <horizon>]
+           [-w <size>] [-v] <taskset file>...
 where
+    r    Rate Monotonic (RM)
     e    Earliest-Deadline-First (EDF)
     l    Least-Laxity-First (LLF)
+    L    Modified Least-Laxity-First (MLLF)
     m    Maximum-Urgency-First (MUF)
-    r    Rate Monotonic (RM)
+    a    Alternative timeline ouput (1 task per line)
+    b    Batch mode: simulate many task set files in parallel
+    d    Discrete-event simulation (jump between scheduling events)
+    j    Simulate the algorithms in parallel (0 threads = all cores)
+    k    Task list implementation: skipl (default), heap, pairing,
+         unrolled, compact or typed
+    p    Longest simulation of a verdict, when the analysis is inconclusive
+         (default 0 = no limit)
+    q    Verdict only: one line per algorithm, exit status 1 if unschedulable
+         or undecided
+    s    Schedulability sweep of random task sets (CSV output), <sweep> is
+         tasks=min:max:step,util=min:max:step,sets=n,seed=n,periods=min:max
+    t    Largest hyperperiod accepted (default 1000000000, 0 = no limit)
+    w    Screen width (for timeline output)
+    v    Verbose output
 
 Ported and expanded by Hans (hans@ele.ufes.br)
 
 ****************************************************************************/
 #include <stdlib.h> /* for malloc() */
 #include <stdio.h>  /* for fopen() */
+#include <stdarg.h> /* for va_list */
 #include <string.h>
 #include <ctype.h>  /* for tolower() */
 #include <math.h>   /* for pow() */
 #include <values.h> /* for MAXINT */
+#include <limits.h> /* for LLONG_MAX */
 #include <ctype.h>  /* for toupper */
 #include <getopt.h> /* for getopt */
+#include <unistd.h> /* for sysconf */
+#include <pthread.h>
 #ifdef DMALLOC
 #include "dmalloc.h"
 #endif
@@ -48,24 +77,29 @@ Ported and expanded by Hans (hans@ele.ufes.br)
 #define MAXINT __INT_MAX__
 #define MAXLONG __INT_MAX__
 #endif
-#include "skipl.h"
+#include "pqueue.h"
 #include "lcmgcd.h"
+#include "workpool.h"
+#include "taskgen.h"
 
-typedef int Time; // = SkiplKeyType
+typedef long long Time; /* = SkiplKeyType.key */
+#define MAXTIME LLONG_MAX
 
-/* alias for Skipl Library */
-#define Node SkiplNode
-#define List SkipList
+/* alias for PQueue Library */
+#define Node PQueueNode
+#define List PQueue
+#define Handle PQueueHandle
+#define Entry struct PQueueEntryStructure
 
-#define GetValue(N) SkiplGetValue(N)
-#define GetKey(N) SkiplGetKey(N)
+#define GetValue(N) PQueueGetValue(N)
+#define GetKey(N) PQueueGetKey(N)
 
-#define Next(N) SkiplNext(N)
-#define Head(L) SkiplHead(L)
-#define IsEmpty(L) SkiplIsEmpty(L)
-#define Delete(L,K) SkiplDelete(L,K)
-#define NewList  SkiplNew
-#define FreeList SkiplFree
+#define Next(L,N) PQueueNext(L,N)
+#define Head(L) PQueueHead(L)
+#define IsEmpty(L) PQueueIsEmpty(L)
+#define Delete(L,K) PQueueDelete(L,K)
+#define NewList() PQueueNew(queuekind)
+#define FreeList PQueueFree
 
 #define MAXLINESIZE 190
 
@@ -76,18 +110,36 @@ typedef int Time; // = SkiplKeyType
 /*  System-related data structures and definitions */
 /***************************************************/
 
+/* command line options (read only during the simulation) */
 int algmask;
 int timelineformat = 1;
 int screenwidth = 72;
 int verbose = 0;
-
-//#define MAX_NAME_LENGTH 50
-char *taskset_title = "";   /* title */
-int num_tasks = 0;          /* number of tasks in task set */
-Time sys_time = 0;          /* current clock value */
-Time max_time = 0;          /* simulation upper limit */
-int context_switches = 0;   /* context switches counter */
-char *timeline_history = 0; /* string with id of scheduled tasks */
+int eventdriven = 0;        /* jump between scheduling events */
+int nthreads = 1;           /* simulations run at the same time */
+int batch = 0;              /* process the task set files in parallel */
+int verdict = 0;            /* only tell if the task set is schedulable */
+Time horizon = 1000000000LL; /* largest hyperperiod accepted (0 = no limit) */
+Time budget = 0;            /* longest simulation of a verdict (0 = no limit) */
+int queuekind = PQUEUE_SKIPL; /* implementation of the task lists */
+
+/* task sets loaded at a time in batch mode, per thread */
+#define BATCHWINDOW 32
+
+/* sweep mode: schedulability of random task sets */
+int sweepmode = 0;
+struct sweep_s {
+    int nmin, nmax, nstep;      /* number of tasks */
+    double umin, umax, ustep;   /* total utilization */
+    int sets;                   /* task sets per point */
+    unsigned int seed;
+    int tmin, tmax;             /* range of the periods */
+} sweep = { 2, 10, 2, 0.50, 1.00, 0.05, 100, 1, 10, 1000 };
+
+/* periods are divisors of this (2^4*3^2*5^2*7), and so is the hyperperiod */
+#define SWEEPHYPERPERIOD 25200
+/* jobs per thread in sweep mode */
+#define SWEEPJOBS 8
 
 /* enum guarantees assignment of values from 0 on
  * IDLE: the task has not started execution yet
@@ -100,73 +152,197 @@ enum state_e {DEAD, IDLE, BLOCKED, READY, RUNNING};
 enum criticality_e {LOW, HIGH};
 
 struct task_struct {
-    char sys_id;
+    int  sys_id;   /* order in the task set file (IDLEID for the idle task) */
     char *name;
     enum state_e state;
     enum criticality_e criticality;
     Time period;
     Time cpu_time;
     Time remaining;
-    Time deadline; /* relative to instance start time */
+    Time deadline; /* of the current instance */
+    Time reldeadline; /* relative to the nominal release (period if not given) */
     Time laxity;
+    Time offset;   /* release time of the first instance */
+    Time jitter;   /* releases are delayed up to this from the nominal one */
+    Time arrival;  /* nominal release time of the next instance */
     int  instance; /* current instance number */
     int  cycles;   /* number of instances executed so far */
+    Handle deadline_h; /* entry in deadline_list (NULL if not there) */
     Time *merit;
+    /* laxity algorithms only */
+    int  laxq;     /* laxity queue of its merit list */
+    int  rank;     /* position in its merit list */
+    Time zero;     /* laxity + sim->decrements while READY */
+    Handle laxity_h; /* entry in its laxity queue (NULL if not READY) */
 };
 
 typedef struct task_struct *Task;
 
-Task  taskset;
-Task  idletask;
-Task  current;
-
-/*
- * list of current task instances, instantiated from
- * its descriptors in 'taskset', and ordered in decreasing
- * value of the chosen scheduling algorithm's figure of merit
- */
-List merit_list;
-/*
- * list of future task requests
- */
-List request_list;
 /*
- * list of current task instances' deadlines, ordered by increasing
- * deadlines
+ * task set as read from the configuration file. It is never changed by
+ * a simulation, that works on its own copy of 'tasks'
  */
-List deadline_list;
+struct taskset_s {
+    char *fname;                /* file it was read from */
+    char *title;                /* title */
+    int   num_tasks;            /* number of tasks in task set */
+    Time  max_time;             /* simulation upper limit */
+    Time  lcm;                  /* hyperperiod */
+    int   steady;               /* stop when the state repeats (asynchronous) */
+    Time  omax;                 /* latest offset */
+    int   capped;               /* max_time is the horizon, not enough hyperperiods */
+    int   constrained;          /* some deadline is before the end of the period */
+    struct task_struct *tasks;  /* tasks[0] is the idle task */
+};
 
+typedef struct taskset_s *TaskSet;
 
-/* Scheduling Algorithms' function prototypes */
+/*
+ * the timeline is kept as a log of the intervals during which a task
+ * (or the idle task) ran without interruption
+ */
+struct segment_s {
+    int   id;                   /* sys_id of the task */
+    Time  start;
+    Time  length;
+};
 
-Task default_dispatcher(void);
+#define INITIALSEGMENTS 256
 
-void monotonic_rate_init(void);
-Task monotonic_rate(void);
-void monotonic_rate_end(void);
+/*
+ * simulation context: all the state changed while simulating a task set
+ * under one algorithm. Contexts share nothing but the (read only) task
+ * set they were created from, so each one can be simulated by a different
+ * thread.
+ */
+struct sim_s {
+    TaskSet ts;
+    FILE *out;                  /* where the simulation reports go (or NULL) */
+    int   misses;               /* deadline failures found so far */
+    Task  failtask;             /* first task to miss (or to be sure to miss) */
+    Time  failtime;             /* its deadline (or when it was known) */
+    int   num_tasks;            /* number of tasks in task set */
+    Time  sys_time;             /* current clock value */
+    Time  max_time;             /* simulation upper limit */
+    int   context_switches;     /* context switches counter */
+    struct segment_s *timeline; /* who ran when (NULL if not needed) */
+    int   nsegments;            /* segments in timeline */
+    int   maxsegments;          /* segments allocated */
+    unsigned long long *states; /* state hashes at the hyperperiod boundaries */
+    Time *snapshots;            /* and the states, STATESIZE(num_tasks) each */
+    int  *statetable;           /* hash set of indexes into states (-1 if free) */
+    int   tablesize;            /* a power of two, twice maxstates */
+    int   nstates;
+    int   maxstates;            /* states allocated */
+    int   repeated;             /* the state repeated: all the schedule is known */
+
+    Task  taskset;              /* private copy of the task set */
+    Task  idletask;
+    Task  current;
+
+    /*
+     * list of current task instances, instantiated from
+     * its descriptors in 'taskset', and ordered in decreasing
+     * value of the chosen scheduling algorithm's figure of merit
+     */
+    List merit_list;
+    /*
+     * list of future task requests
+     */
+    List request_list;
+    /*
+     * list of current task instances' deadlines, ordered by increasing
+     * deadlines
+     */
+    List deadline_list;
+    /*
+     * MUF only: tasks in the critical set and all the others
+     */
+    List high_crit_l, low_crit_l;
+    /*
+     * LLF and MUF: the READY tasks of each merit list by the instant their
+     * laxity gets to zero, counted in decrements (ticks spent READY)
+     */
+    List laxity_q[2];
+    Time decrements;
+    int  releases;              /* tasks released at this tick */
+
+    /* tasks to insert at a time in a list (released at the same time) */
+    Entry  *batch;
+    Entry  *sorttmp;
+    Handle *handles;
+};
 
-void earliest_deadline_init(void);
-Task earliest_deadline(void);
-void earliest_deadline_end(void);
+typedef struct sim_s *Sim;
 
-void least_laxity_init(void);
-Task least_laxity(void);
-void least_laxity_end(void);
 
-void maximum_urgency_first_init(void);
-Task maximum_urgency_first(void);
-void maximum_urgency_first_end(void);
+/* Scheduling Algorithms' function prototypes */
 
-/* ids used to identify tasks */
-char idtable[]="abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
-int  idindex = 0;
+Task default_dispatcher(Sim sim);
+
+void monotonic_rate_init(Sim sim);
+Task monotonic_rate(Sim sim);
+void monotonic_rate_end(Sim sim);
+int monotonic_rate_bounds(Sim sim);
+int monotonic_rate_analysis(Sim sim);
+
+void earliest_deadline_init(Sim sim);
+Task earliest_deadline(Sim sim);
+void earliest_deadline_end(Sim sim);
+int earliest_deadline_bounds(Sim sim);
+int earliest_deadline_analysis(Sim sim);
+
+void least_laxity_init(Sim sim);
+Task least_laxity(Sim sim);
+void least_laxity_end(Sim sim);
+Time least_laxity_horizon(Sim sim);
+void least_laxity_elapse(Sim sim, Time ticks);
+
+void modified_least_laxity_init(Sim sim);
+Task modified_least_laxity(Sim sim);
+Time modified_least_laxity_horizon(Sim sim);
+
+void maximum_urgency_first_init(Sim sim);
+Task maximum_urgency_first(Sim sim);
+void maximum_urgency_first_end(Sim sim);
+Time maximum_urgency_first_horizon(Sim sim);
+void maximum_urgency_first_elapse(Sim sim, Time ticks);
+
+/* letters used to show the tasks (the ones after the last are all '#') */
+const char idtable[]="abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+#define IDLETTERS (sizeof(idtable)-1)
+#define IDLEID (-1)
+
+/* how a task is shown in the timeline and messages */
+char idchar(int sys_id) {
+    if (sys_id == IDLEID)
+        return '.';
+    if (sys_id < IDLETTERS)
+        return idtable[sys_id];
+    return '#';
+}
 
+/*
+ * horizon and elapse are used only by the event-driven engine:
+ * horizon returns how many ticks ahead the scheduler may change its mind
+ * on its own (NULL means only releases, completions and deadlines matter)
+ * and elapse applies the per tick bookkeeping of the skipped ticks.
+ * bounds (NULL if there are none) are the cheap sufficient tests of the
+ * load: they return the tier that proves the task set schedulable, or
+ * NOTIER. analysis (NULL if there is none) is an analytic test run after
+ * initialize: it returns TRUE if it gives the verdict (sim->failtask and
+ * failtime) without simulating.
+ */
 struct alg_s {
     char id;
     char *label;
-    void (*initialize)(void);
-    Task (*scheduler)(void);
-    void (*finish)(void);
+    void (*initialize)(Sim sim);
+    Task (*scheduler)(Sim sim);
+    void (*finish)(Sim sim);
+    Time (*horizon)(Sim sim);
+    void (*elapse)(Sim sim, Time ticks);
+    int  (*bounds)(Sim sim);
+    int  (*analysis)(Sim sim);
 };
 
 struct alg_s algtable[] = {
@@ -174,27 +350,57 @@ struct alg_s algtable[] = {
         "Rate Monotonic (RM)",
         monotonic_rate_init,
         default_dispatcher,
-        monotonic_rate_end
+        monotonic_rate_end,
+        NULL,
+        NULL,
+        monotonic_rate_bounds,
+        monotonic_rate_analysis
     },
     {   'e',
         "Earliest-Deadline-First (EDF)",
         earliest_deadline_init,
         default_dispatcher,
-        earliest_deadline_end
+        earliest_deadline_end,
+        NULL,
+        NULL,
+        earliest_deadline_bounds,
+        earliest_deadline_analysis
     },
     {   'l',
         "Least-Laxity-First (LLF)",
         least_laxity_init,
         least_laxity,
-        least_laxity_end
+        least_laxity_end,
+        least_laxity_horizon,
+        least_laxity_elapse,
+        NULL,
+        NULL
+    },
+    {   'L',
+        "Modified Least-Laxity-First (MLLF)",
+        modified_least_laxity_init,
+        modified_least_laxity,
+        least_laxity_end,
+        modified_least_laxity_horizon,
+        least_laxity_elapse,
+        NULL,
+        NULL
     },
     {   'm',
         "Maximum-Urgency-First (MUF)",
         maximum_urgency_first_init,
         maximum_urgency_first,
-        maximum_urgency_first_end
+        maximum_urgency_first_end,
+        maximum_urgency_first_horizon,
+        maximum_urgency_first_elapse,
+        NULL,
+        NULL
     },
     {   '\0',
+        NULL,
+        NULL,
+        NULL,
+        NULL,
         NULL,
         NULL,
         NULL,
@@ -203,32 +409,107 @@ struct alg_s algtable[] = {
 };
 
 typedef struct alg_s *Alg;
+#define NALGS (sizeof(algtable)/sizeof(algtable[0]))
+
+/*
+ * tiers of the admission pipeline, from the cheapest test on. The verdict
+ * is undecided when the tests before the simulation are inconclusive and
+ * the time range is longer than the budget (OVERBUDGET), or when the
+ * simulation found no failure but did not cover the whole schedule
+ * (PARTIAL)
+ */
+enum tier_e {UTILIZATION, HYPERBOLIC, HARMONIC, ANALYSIS, SIMULATION, OVERBUDGET, PARTIAL, NTIERS};
+const char *tiername[NTIERS] = {
+    "utilization", "hyperbolic", "harmonic", "analysis", "simulation", "budget", "partial"
+};
+#define UNDECIDED(T) ((T) >= OVERBUDGET)
+#define NOTIER (-1)
+/* rounding allowance of the tests of the load in floating point */
+#define LOADEPSILON 1e-9
 /*
  * Interface to Skipl Library
  */
 
 /* let's make a new key for argument to the library:     */
-/* its two MSBytes will hold the original argument       */
-/* and the LSByte the sys_id of the task arguement       */
+/* it holds the original argument and, to break ties,    */
+/* the sys_id of the task argument                       */
 /* This way we have a unique key for search and delete   */
 
-int build_keyid(int key, int id) {
-    return (key<<8) + (id&0xFF);
+SkiplKeyType build_keyid(Time key, int id) {
+    SkiplKeyType keyid;
+
+    keyid.key = key;
+    keyid.tie = id;
+    return keyid;
 }
 
-int get_key(int keyid) {
-    return keyid>>8;
+Time get_key(SkiplKeyType keyid) {
+    return keyid.key;
 }
 
 
-void insert_task(List task_l, int key, Task task) {
-    int new_key = build_keyid(key,task->sys_id);
-    SkiplInsert(task_l, new_key, task);
+/* returns the handle of the entry, to delete it without a search */
+Handle insert_task(List task_l, Time key, Task task) {
+    SkiplKeyType new_key = build_keyid(key,task->sys_id);
+    return PQueueInsertHandle(task_l, new_key, task);
+}
+
+/* deletes the entry of the handle, if any, and clears it */
+void delete_task(List task_l, Handle *h){
+    if (*h != NULL) {
+        PQueueDeleteHandle(task_l, *h);
+        *h = NULL;
+    }
+}
+
+/*
+ * natural merge sort by key: the runs already in order are merged in
+ * pairs until one is left, so a batch that is sorted costs one pass
+ */
+void sortbatch(Entry e[], Entry tmp[], int n) {
+    Entry *from = e, *to = tmp, *t;
+    int i, j, k, mid, end, runs;
+
+    do {
+        runs = 0;
+        for (i=0; i<n; i=end) {
+            for (mid=i+1; mid<n && !SKIPL_LESS(from[mid].key, from[mid-1].key); mid++)
+                ;
+            for (end=mid+1; end<n && !SKIPL_LESS(from[end].key, from[end-1].key); end++)
+                ;
+            if (end > n)
+                end = n;
+            for (j=i, k=mid; j<mid && k<end; )
+                to[i++] = SKIPL_LESS(from[k].key, from[j].key)? from[k++] : from[j++];
+            while (j<mid)
+                to[i++] = from[j++];
+            while (k<end)
+                to[i++] = from[k++];
+            runs++;
+        }
+        t = from; from = to; to = t;
+    } while (runs > 1);
+    if (from != e)
+        memcpy(e, from, n*sizeof(Entry));
+}
+
+/*
+ * inserts the n tasks in sim->batch with their keys, sorted first so that
+ * the list is walked once for all of them. The handle of the i-th task
+ * (after sorting) goes to h[i] if h is not NULL
+ */
+void insert_batch(Sim sim, List task_l, int n, Handle h[]) {
+    sortbatch(sim->batch, sim->sorttmp, n);
+    PQueueInsertSorted(task_l, sim->batch, n, h);
 }
 
-void delete_task(List task_l, int key, Task task){
-    int new_key = build_keyid(key,task->sys_id);
-    Delete(task_l, new_key);
+/* removes the first task of a list that is not empty */
+Task pop_task(List task_l) {
+    SkiplKeyType key;
+    void *task;
+
+    PQueuePopMin(task_l, &key, &task);
+    return task;
 }
 
 /*
@@ -236,78 +517,325 @@ void delete_task(List task_l, int key, Task task){
  */
 
 void init(int argc, char *argv[]);
-void drawtimeline(char *);
-Time now(void);
-void taskinit(Task task, char id);
-
-Task getleastlaxityandupdate(List l);
+void parsesweep(char *spec);
+void drawtimeline(Sim sim, char *);
+void axisstring(char *buf, Time from, int length, Time max_time, int digit);
+void taskinit(Sim sim, Task task, char id);
+Time releasejitter(Sim sim, Task task, int k);
+void requesttasks(Sim sim, int n);
+void releasetasks(Sim sim, int n);
+Time firstboundary(TaskSet ts);
+void growstates(Sim sim);
+int repeatedstate(Sim sim);
+
+Time tasklaxity(Sim sim, Task task);
+void changestate(Sim sim, Task task, enum state_e state);
+void laxityleave(Sim sim, Task task);
+void laxityenter(Sim sim, Task task);
+void laxityqueues(Sim sim, List l[], int n);
+void laxityinit(Sim sim, char *name);
+Task getleastlaxity(Sim sim, int q);
+Task getearliestdeadline(Sim sim, Task least);
+Time getlaxityhorizon(Sim sim, int q);
 
 Task getfirstready(List l);
 void showtasklist(List l, char sysid);
 
-int readtaskset(char *fname);
-void showtaskset(void);
+TaskSet readtaskset(FILE *out, char *fname);
+TaskSet randomtaskset(int n, double u, int periods[], int nperiods,
+                      unsigned int *seed);
+void idletaskinit(Task idletask);
+Time hyperperiod(TaskSet ts);
+void showtaskset(FILE *out, TaskSet ts);
+void cleartaskset(TaskSet ts);
+
+Sim newsim(TaskSet ts);
+void freesim(Sim sim);
+void simprintf(Sim sim, const char *fmt, ...);
+void addsegment(Sim sim, int id, Time start, Time length);
+void timelinestring(Sim sim, char *buf, Time from, int length, Task only);
+void taskfailure(Sim sim, Task task);
+void deadlinepassed(SkiplKeyType key, void *value, void *arg);
+int overloaded(Sim sim);
+Time overloadpoint(Sim sim, Time limit);
+int loadtier(Sim sim, Alg palg, int anyfailure);
+int wholeschedule(Sim sim);
+int admission(Sim sim, Alg palg, int anyfailure);
+int runalgorithm(Sim sim, Alg palg);
+int runtaskset(FILE *out, TaskSet ts);
+void reportswitches(FILE *out, int switches[]);
+int runparallel(TaskSet ts);
+int runbatch(int nfiles, char *files[]);
+void runsweep(void);
 
 /*
  * simulation routine
  */
 
-void simulate(Alg palg) {
+/* report to the output of the simulation, if it has one */
+void simprintf(Sim sim, const char *fmt, ...) {
+    va_list ap;
+
+    if( sim->out == NULL )
+        return;
+    va_start(ap, fmt);
+    vfprintf(sim->out, fmt, ap);
+    va_end(ap);
+}
+
+/* register that task 'id' ran from 'start' for 'length' time units */
+void addsegment(Sim sim, int id, Time start, Time length) {
+    struct segment_s *last;
+
+    if (sim->timeline == NULL)
+        return;
+    last = sim->timeline+sim->nsegments-1;
+    if (sim->nsegments > 0 && last->id == id && last->start+last->length == start) {
+        last->length += length;
+        return;
+    }
+    if (sim->nsegments == sim->maxsegments) {
+        sim->maxsegments *= 2;
+        sim->timeline = realloc(sim->timeline, sim->maxsegments*sizeof(struct segment_s));
+        if ( !sim->timeline ) {
+            fprintf(stderr, "Not enough memory available for timeline\n");
+            exit(-1);
+        }
+    }
+    last = sim->timeline+sim->nsegments++;
+    last->id = id;
+    last->start = start;
+    last->length = length;
+}
+
+/* 'task' missed its deadline or will miss it for sure */
+void taskfailure(Sim sim, Task task) {
+    if( sim->failtask == NULL ) {
+        sim->failtask = task;
+        sim->failtime = sim->sys_time;
+    }
+}
+
+/* the deadline of 'task' is over: it is a failure if it did not finish */
+void deadlinepassed(SkiplKeyType key, void *value, void *arg) {
+    Sim sim = arg;
+    Task task = value;
+
+    task->deadline_h = NULL;
+    if (task->state != DEAD) {
+        sim->misses++;
+        taskfailure(sim, task);
+        simprintf(sim, "At %lld: task %c (\"%s\"), instance %d, Deadline Failure\n",
+            sim->sys_time, idchar(task->sys_id), task->name, task->instance);
+    }
+}
+
+/* one time unit of the simulation: the one starting at sys_time */
+void tick(Sim sim, Alg palg) {
     Node n;
     Task task, new;
+    int i;
+    Task current = sim->current;
+
+    /* update current's remaining time: another time unit was executed */
+    /* and if the current task emptied its allocated time... */
+    if (current!=sim->idletask  &&  -- current->remaining == 0) {
+        changestate(sim, current, DEAD);
+        current->cycles++;
+        delete_task(sim->deadline_list, &current->deadline_h);
+        current = sim->current = sim->idletask;
+    }
 
-    context_switches=0;
-    current = idletask;
-    /* select which task to run next */
-    for (sys_time = 0;
-        /* the first condition is 'merit_list not empty' */
-        (!IsEmpty(merit_list) || !IsEmpty(request_list))
-            &&  sys_time <= max_time;
-        sys_time++) {
-
-            /* update current's remaining time: another time unit was executed */
-            /* and if the current task emptied its allocated time... */
-            if (current!=idletask  &&  -- current->remaining == 0) {
-                current->state = DEAD;
-                current->cycles++;
-                delete_task(deadline_list, current->deadline, current);
-                current = idletask;
-            }
+    /* Look out for deadline failures */
+    PQueueDeleteUpTo(sim->deadline_list, build_keyid(sim->sys_time, INT_MAX),
+        deadlinepassed, sim);
 
-            /* Look out for deadline failures */
-            while ((n=Head(deadline_list)) && (get_key(GetKey(n))<=sys_time)) {
-                task=GetValue(n);
-                if (task->state != DEAD) {
-                    printf("At %d: task %c (\"%s\"), instance %d, Deadline Failure\n",
-                        sys_time, task->sys_id, task->name, task->instance);
-                }
-                Delete(deadline_list, GetKey(n));
-            }
+    /* if it is time to launch tasks... (all of them are inserted at once) */
+    for (i=0; (n=Head(sim->request_list)) && get_key(GetKey(n)) <= sim->sys_time; i++) {
+        taskinit(sim, (task=pop_task(sim->request_list)), palg->id);
+        sim->batch[i].value = task;
+    }
+    if (i > 0)
+        releasetasks(sim, i);
+    sim->releases = i;
+
+    new = (palg->scheduler)(sim);
+
+    /* swap and register who's using the processor */
+    if (current!=new){
+        sim->context_switches++;
+        changestate(sim, current, READY);
+        current=sim->current=new;
+        changestate(sim, current, RUNNING);
+    }
+    addsegment(sim, current->sys_id, sim->sys_time, 1);
+    #ifdef DEBUG
+    simprintf(sim, "%lld: %c\n", sim->sys_time, idchar(current->sys_id));
+    #endif
+}
 
-            /* if it is time to launch a task... */
-            while (get_key(GetKey(n=Head(request_list))) <= sys_time) {
-                taskinit((task=GetValue(n)),palg->id);
-                Delete(request_list, GetKey(n));
-                insert_task(deadline_list, task->deadline, task);
-                insert_task(request_list, task->deadline, task);
-            }
+/*
+ * Event-driven engine: after a tick, nothing happens until the next
+ * release, the completion of current, the next deadline or (for the
+ * laxity based algorithms) the next laxity crossing. The ticks in between
+ * are accounted for in one step and sys_time is left at the tick just
+ * before the next event.
+ */
+void skiptonextevent(Sim sim, Alg palg) {
+    Node n;
+    Time next, t, gap;
+    Task current = sim->current;
+
+    next = sim->max_time+1;
+    if (current!=sim->idletask  &&  sim->sys_time+current->remaining < next)
+        next = sim->sys_time+current->remaining;
+    if ((n=Head(sim->deadline_list)) && (t=get_key(GetKey(n))) < next)
+        next = t;
+    if ((n=Head(sim->request_list)) && (t=get_key(GetKey(n))) < next)
+        next = t;
+    if (palg->horizon && (t=(palg->horizon)(sim)) <= next-sim->sys_time)
+        next = sim->sys_time+t;
+    /* the state must be sampled at the hyperperiod boundaries after omax */
+    if (sim->ts->steady) {
+        t = (sim->sys_time/sim->ts->lcm+1)*sim->ts->lcm;
+        if (t < sim->ts->omax)
+            t = firstboundary(sim->ts);
+        if (t < next)
+            next = t;
+    }
 
-            new = (palg->scheduler)();
+    gap = next-sim->sys_time-1;
+    if (gap <= 0)
+        return;
+    if (current!=sim->idletask)
+        current->remaining -= gap;
+    if (palg->elapse)
+        (palg->elapse)(sim, gap);
+    addsegment(sim, current->sys_id, sim->sys_time+1, gap);
+    sim->sys_time += gap;
+}
 
-            /* swap and register who's using the processor */
-            if (current!=new){
-                context_switches++;
-                current->state=READY;
-                current=new;
-                current->state=RUNNING;
-            }
-            timeline_history[sys_time]= current->sys_id;
-            #ifdef DEBUG
-            printf("%d: %s\n", sys_time, timeline_history);
-            #endif
+/*
+ * Asynchronous task sets (with offsets or jitter) do not necessarily
+ * repeat from time 0, but the releases relative to the hyperperiod
+ * boundaries do once all the tasks have been released. So the state is
+ * saved at each boundary from the first one at or after the latest offset
+ * (before it the next release of some task is nearer at each boundary)
+ * and, as soon as it is the same as in an earlier one, everything from
+ * then on is a repetition. The state is taken before the tick at the
+ * boundary. The states are found by their hash in an open addressing
+ * set, and a hash that is already there is only taken as a repetition if
+ * the whole state is the same.
+ * returns TRUE if the state at sys_time was already seen
+ */
+#define HASHSTEP(H,V) ((H) = ((H) ^ (unsigned long long) (V)) * 1099511628211ULL)
+/* the current task, and the state, remaining, laxity, deadline, arrival and phase of each task */
+#define STATESIZE(N) (1+6*(N))
+/* states allocated at first (they double when needed) */
+#define INITIALSTATES 16
+
+/* first hyperperiod boundary where the state is saved */
+Time firstboundary(TaskSet ts) {
+    Time b = (ts->omax+ts->lcm-1)/ts->lcm*ts->lcm;
+
+    return (b > 0)? b : ts->lcm;
+}
+
+/* make room for twice the states, and hash them again in a table twice as large */
+void growstates(Sim sim) {
+    int i, k, size = STATESIZE(sim->num_tasks);
+
+    if (sim->maxstates > 0) {
+        sim->maxstates *= 2;
+        free(sim->statetable);
+    }
+    else
+        sim->maxstates = INITIALSTATES;
+    sim->tablesize = 2*sim->maxstates;
+    sim->states = realloc(sim->states, sim->maxstates*sizeof(unsigned long long));
+    sim->snapshots = realloc(sim->snapshots, (size_t) sim->maxstates*size*sizeof(Time));
+    sim->statetable = malloc(sim->tablesize*sizeof(int));
+    if ( !sim->states || !sim->snapshots || !sim->statetable ) {
+        fprintf(stderr, "Not enough memory available\n");
+        exit(-1);
+    }
+    memset(sim->statetable, -1, sim->tablesize*sizeof(int));
+    for (k=0; k<sim->nstates; k++) {
+        for (i=sim->states[k] & (sim->tablesize-1); sim->statetable[i] >= 0;
+             i=(i+1) & (sim->tablesize-1))
+            ;
+        sim->statetable[i] = k;
+    }
+}
+
+int repeatedstate(Sim sim) {
+    unsigned long long h = 14695981039346656037ULL;   /* FNV-1a */
+    Time t = sim->sys_time;
+    Time *state;
+    Task task;
+    int i, k, size = STATESIZE(sim->num_tasks);
+
+    if (sim->nstates == sim->maxstates)
+        growstates(sim);
+    state = sim->snapshots + (size_t) sim->nstates*size;
+    state[0] = sim->current->sys_id;
+    for (i=1; i<=sim->num_tasks; i++) {
+        task = sim->taskset+i;
+        state[6*i-5] = task->state;
+        state[6*i-4] = task->remaining;
+        state[6*i-3] = tasklaxity(sim, task);
+        state[6*i-2] = task->deadline-t;
+        state[6*i-1] = task->arrival-t;
+        state[6*i] = task->instance % (sim->ts->lcm/task->period);
+    }
+    for (k=0; k<size; k++)
+        HASHSTEP(h, state[k]);
+
+    for (i=h & (sim->tablesize-1); (k=sim->statetable[i]) >= 0; i=(i+1) & (sim->tablesize-1)) {
+        if (sim->states[k] == h
+            && memcmp(sim->snapshots + (size_t) k*size, state, size*sizeof(Time)) == 0) {
+            simprintf(sim, "At %lld: same state as at %lld, the schedule repeats from then on\n",
+                t, firstboundary(sim->ts)+k*sim->ts->lcm);
+            return TRUE;
+        }
     }
+    sim->statetable[i] = sim->nstates;
+    sim->states[sim->nstates++] = h;
+    return FALSE;
+}
 
+void simulate(Sim sim, Alg palg) {
 
+    sim->context_switches=0;
+    sim->decrements=0;
+    sim->nsegments=0;
+    sim->misses=0;
+    sim->nstates=0;
+    sim->repeated=FALSE;
+    sim->failtask = NULL;
+    sim->current = sim->idletask;
+    /* select which task to run next */
+    for (sim->sys_time = 0;
+        /* the first condition is 'merit_list not empty' */
+        (!IsEmpty(sim->merit_list) || !IsEmpty(sim->request_list))
+            &&  sim->sys_time <= sim->max_time
+            /* and, for a verdict, the first failure is enough */
+            &&  !(verdict && sim->failtask);
+        sim->sys_time++) {
+            if (sim->ts->steady && sim->sys_time > 0 && sim->sys_time >= sim->ts->omax
+                && sim->sys_time%sim->ts->lcm == 0 && repeatedstate(sim)) {
+                /* only the simulated part is shown */
+                sim->max_time = sim->sys_time-1;
+                sim->repeated = TRUE;
+                break;
+            }
+            tick(sim, palg);
+            if (eventdriven)
+                skiptonextevent(sim, palg);
+    }
+    if (sim->ts->steady && !sim->repeated && sim->failtask == NULL)
+        simprintf(sim, "No repeated state up to %lld%s: the schedule after it is not known\n",
+            sim->max_time, sim->ts->capped? " (the horizon)" : "");
 }
 
 
@@ -317,11 +845,23 @@ rtalgs: calculate the schedulability of a task set\n\
 Usage:\
 \trtalgs {";
 char *help2="\
- } [-a] [-w <size>] [-v] <taskset file>\n\
+ } [-a] [-b] [-d] [-j <threads>] [-k <queue>] [-p <budget>] [-q] [-s <sweep>] [-t <horizon>] [-w <size>] [-v] <taskset file>...\n\
 where\n";
 char*help3="\
 \t\t(At least one of the above algorithms must be specified)\n\
 \ta\tAlternative timeline ouput (1 task per line)\n\
+\tb\tBatch mode: simulate many task set files in parallel\n\
+\td\tDiscrete-event simulation (jump between scheduling events)\n\
+\tj\tSimulate the algorithms in parallel (0 threads = all cores)\n\
+\tk\tTask list implementation: skipl (default), heap, pairing,\n\
+\t\tunrolled, compact or typed\n\
+\tp\tLongest simulation of a verdict, when the analysis is inconclusive\n\
+\t\t(default 0 = no limit)\n\
+\tq\tVerdict only: one line per algorithm, exit status 1 if unschedulable\n\
+\t\tor undecided\n\
+\ts\tSchedulability sweep of random task sets (CSV output), <sweep> is\n\
+\t\ttasks=min:max:step,util=min:max:step,sets=n,seed=n,periods=min:max\n\
+\tt\tLargest hyperperiod accepted (default 1000000000, 0 = no limit)\n\
 \tw\tScreen width (for timeline output)\n\
 \tv\tVerbose output\n";
 
@@ -343,190 +883,391 @@ struct alg_s *p;
     fputs(help3,stderr);
 }
 
-void drawtimeline(char *label) {
-    char *time_axe_high;
-    char *time_axe_med;
-    char *time_axe_low;
-    char *p;
+/*
+ * fill buf with the ids of the tasks that ran in [from,from+length)
+ * and a '\0' after them. The time not simulated is filled with '\0' too.
+ * If 'only' is not NULL, the time used by other tasks is left blank
+ */
+void timelinestring(Sim sim, char *buf, Time from, int length, Task only) {
+    struct segment_s *seg;
+    Time t, end;
+    int lo, hi, mid;
+
+    memset(buf, '\0', length+1);
+    /* binary search for the first segment ending after 'from' */
+    lo = 0;
+    hi = sim->nsegments;
+    while (lo < hi) {
+        mid = (lo+hi)/2;
+        seg = sim->timeline+mid;
+        if (seg->start+seg->length <= from)
+            lo = mid+1;
+        else
+            hi = mid;
+    }
+    for ( ; lo<sim->nsegments && (seg=sim->timeline+lo)->start < from+length; lo++) {
+        t = (seg->start > from)? seg->start : from;
+        end = seg->start+seg->length;
+        if (end > from+length)
+            end = from+length;
+        if (only == NULL || only->sys_id == seg->id)
+            memset(buf+(t-from), idchar(seg->id), end-t);
+        else
+            memset(buf+(t-from), ' ', end-t);
+    }
+}
+
+/*
+ * time reference: digit 0 is the units one, 1 the tens (only at the
+ * multiples of 10) and 2 the hundreds (only at the multiples of 100).
+ * The last time has all of them.
+ */
+void axisstring(char *buf, Time from, int length, Time max_time, int digit) {
+    Time i;
     char c;
-    int i, j, no_lines, task_axe_length, offset, length;
-    static char *info = NULL;
-    static int infosize = 0;
-
-    if( info == NULL || infosize != screenwidth ) { /* alloc only once */
-        if( screenwidth == 0 )
-            screenwidth = max_time;
-        infosize = screenwidth;
-        if( info )
-            free(info);
-        info = malloc(screenwidth+2);
-        if( info == NULL ) {
-            fprintf(stderr,"Not enough memory for timeline\n");
-            exit(-1);
-        }
+
+    for (i=from; i<from+length; i++) {
+        c = i%10+'0';
+        if (digit >= 1)
+            c = (c=='0')? (i/10)%10+'0' : ' ';
+        if (digit >= 2)
+            c = (c=='0')? (i/100)%10+'0' : ' ';
+        if (i == max_time && digit == 1)
+            c = (max_time/10)%10+'0';
+        if (i == max_time && digit == 2)
+            c = (max_time/100)%10+'0';
+        buf[i-from] = c;
     }
+    buf[length] = '\0';
+}
 
-    time_axe_high = malloc(max_time+2);
-    time_axe_med = malloc(max_time+2);
-    time_axe_low = malloc(max_time+2);
-    if( !time_axe_high || !time_axe_med || !time_axe_low ) {
+void drawtimeline(Sim sim, char *label) {
+    int i, j, length;
+    Time task_axe_length, offset;
+    char *info;
+    Time width = screenwidth;
+    Time max_time = sim->max_time;
+    Task taskset = sim->taskset;
+
+    if( width == 0 )
+        width = max_time;
+    info = calloc(width+2, 1);
+    if( info == NULL ) {
         fprintf(stderr,"Not enough memory for timeline\n");
         exit(-1);
     }
 
-    /* build output time reference */
-    for (i=0; i<=max_time; i++) {
-        c = time_axe_low[i] = i%10+'0';
-        c = time_axe_med[i] = (c=='0')? (i/10)%10+'0' : ' ';
-        time_axe_high[i] = (c=='0')? (i/100)%10+'0' : ' ';
-    }
-    time_axe_med[max_time] = (max_time/10)%10+'0';
-    time_axe_high[max_time] = (max_time/100)%10+'0';
-    time_axe_low[max_time+1] = '\0';
-    time_axe_med[max_time+1] = '\0';
-    time_axe_high[max_time+1] = '\0';
-
     task_axe_length = max_time+1;
-    no_lines = task_axe_length/screenwidth;
-    if (task_axe_length%screenwidth !=0)
-        no_lines++;
-
-    /* finally print timeline */
-    printf("\nTimeline for %s algorithm\n\n", label);
-    for (i=1, offset=0; i<=no_lines; i++, offset+=screenwidth) {
-        if (i==no_lines) {
-            length = ((task_axe_length-1)%screenwidth+1);
-            memset(info, '\0', screenwidth);
+
+    /* finally print timeline, one line of 'width' time units at a time */
+    simprintf(sim, "\nTimeline for %s algorithm\n\n", label);
+    for (offset=0; offset<task_axe_length; offset+=width) {
+        if (offset+width >= task_axe_length) {
+            length = ((task_axe_length-1)%width+1);
         } else {
-            length = screenwidth;
+            length = width;
         }
+        /* axes */
         if( max_time >= 100 ) {
-            strncpy(info, time_axe_high + offset, length);
-            printf("%s\n", info);
+            axisstring(info, offset, length, max_time, 2);
+            simprintf(sim, "%s\n", info);
         }
-        /* axes */
-        strncpy(info, time_axe_med  + offset, length);
-        printf("%s\n", info);
-        strncpy(info, time_axe_low  + offset, length);
-        printf("%s\n", info);
+        axisstring(info, offset, length, max_time, 1);
+        simprintf(sim, "%s\n", info);
+        axisstring(info, offset, length, max_time, 0);
+        simprintf(sim, "%s\n", info);
         /* time line */
         if( timelineformat == 1) {
-            strncpy(info, timeline_history + offset, length);
-            printf("%s\n", info);
+            timelinestring(sim, info, offset, length, NULL);
+            simprintf(sim, "%s\n", info);
         } else {
-            for(j=num_tasks;j>=0;j--) {
-                strncpy(info, timeline_history + offset, length);
-                p = info;
-                while ( *p ) {
-                    if( *p != taskset[j].sys_id ) *p = ' ';
-                    p++;
-                }
-                printf("%s\n", info);
+            for(j=sim->num_tasks;j>=0;j--) {
+                timelinestring(sim, info, offset, length, taskset+j);
+                simprintf(sim, "%s\n", info);
             }
         }
         /* axes */
-        strncpy(info, time_axe_low  + offset, length);
-        printf("%s\n", info);
-        strncpy(info, time_axe_med  + offset, length);
-        printf("%s\n", info);
+        axisstring(info, offset, length, max_time, 0);
+        simprintf(sim, "%s\n", info);
+        axisstring(info, offset, length, max_time, 1);
+        simprintf(sim, "%s\n", info);
         if( max_time >= 100 ) {
-            strncpy(info, time_axe_high + offset, length);
-            printf("%s\n", info);
+            axisstring(info, offset, length, max_time, 2);
+            simprintf(sim, "%s\n", info);
         }
     }
-    printf("\n%d context switches\n", context_switches);
+    simprintf(sim, "\n%d context switches\n", sim->context_switches);
 
-    puts("Cross-reference Names:");
-    for(i=num_tasks; i>=0; i--)
-        printf("%c\t%s\n", (taskset+i)->sys_id, (taskset+i)->name);
+    simprintf(sim, "Cross-reference Names:\n");
+    for(i=sim->num_tasks; i>=0; i--)
+        simprintf(sim, "%c\t%s\n", idchar((taskset+i)->sys_id), (taskset+i)->name);
 
-    free(time_axe_low);
-    free(time_axe_med);
-    free(time_axe_high);
+    free(info);
 }
 
 /* set up instance's dynamic parameters */
-void taskinit(Task task, char id) {
+void taskinit(Sim sim, Task task, char id) {
+    laxityleave(sim, task);
     task->state    = READY;
     task->remaining= task->cpu_time;
-    task->deadline = sys_time + task->period;
+    /* the deadline is relative to the nominal release, not the jittered one */
+    task->deadline = task->arrival + task->reldeadline;
+    task->arrival += task->period;
     task->instance++;
 
     /* task->laxity       = task->deadline - now() - task->remaining;
-     * but task->deadline = now() + task->period;
      * and task->remaining= task->cpu_time,
-     * ==>  task->laxity  = task->period - task->cpu_time;
+     * ==>  task->laxity  = task->deadline - now() - task->cpu_time;
+     * (that is, reldeadline - cpu_time, when released without jitter)
      *****************************************************************************/
-    task->laxity = task->period - task->cpu_time;
-    if ( id == 'l'  ||  id == 'm' )     /* The final value must be incremented to cancel */
-        task->laxity++;                 /* the laxity update of the very first instant */
+    task->laxity = task->deadline - sim->sys_time - task->cpu_time;
+    /* The final value must be incremented to cancel the laxity update of the very first instant */
+    if ( id == 'l'  ||  id == 'L'  ||  id == 'm' )
+        task->laxity++;
+    laxityenter(sim, task);
+}
+
+/*
+ * release delay of the k-th instance (from 0) of a task, in [0,jitter].
+ * It is pseudo-random but the same for all algorithms and repeats every
+ * hyperperiod, so the schedule can reach a steady state
+ */
+Time releasejitter(Sim sim, Task task, int k) {
+    unsigned int x;
+
+    if (task->jitter == 0)
+        return 0;
+    if (sim->ts->lcm)
+        k %= sim->ts->lcm/task->period;
+    x = (unsigned int) (task-sim->taskset)*2654435761U
+        ^ (unsigned int) k*40503U;
+    x ^= x >> 16;
+    x *= 0x7feb352dU;
+    x ^= x >> 15;
+    x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return x % (task->jitter+1);
+}
+
+/* schedule the release of the next instance of the n tasks in sim->batch */
+void requesttasks(Sim sim, int n) {
+    Task task;
+    int i;
+
+    for (i=0; i<n; i++) {
+        task = sim->batch[i].value;
+        sim->batch[i].key = build_keyid(
+            task->arrival+releasejitter(sim, task, task->instance), task->sys_id);
+    }
+    insert_batch(sim, sim->request_list, n, NULL);
+}
+
+/* the n tasks just initialized in sim->batch wait for their deadlines */
+void releasetasks(Sim sim, int n) {
+    Task task;
+    int i;
+
+    for (i=0; i<n; i++) {
+        task = sim->batch[i].value;
+        sim->batch[i].key = build_keyid(task->deadline, task->sys_id);
+    }
+    insert_batch(sim, sim->deadline_list, n, sim->handles);
+    for (i=0; i<n; i++)
+        ((Task) sim->batch[i].value)->deadline_h = sim->handles[i];
+    requesttasks(sim, n);
 }
 
-Task default_dispatcher(void) {
+Task default_dispatcher(Sim sim) {
     Task task;
 
-    if ((task=getfirstready(merit_list))==NULL)
-        return idletask;
-    else if (current == idletask)
+    if ((task=getfirstready(sim->merit_list))==NULL)
+        return sim->idletask;
+    else if (sim->current == sim->idletask)
         return task;
     else /* current task prevails other tasks with same merit */
-        return (*task->merit == *current->merit)? current : task;
+        return (*task->merit == *sim->current->merit)? sim->current : task;
 }
 
 
 /*
  *     Rate Monotonic (RM) algorithm
  ****************************************************************************/
-void monotonic_rate_init(void)
+void monotonic_rate_init(Sim sim)
 {
     int i;
     Node n;
     Task task;      /* 'task' is the task with 'lesser' period */
     float task_load = 0.0, critical_task_load=0.0, schedulability_bound;
+    int num_tasks = sim->num_tasks;
 
     /* in the RM case, 'deadline_list' is different from the 'merit_list' */
-    deadline_list = NewList();
+    sim->deadline_list = NewList();
 
     /* calculate n*(2^1/n - 1) */
     schedulability_bound= num_tasks * (pow(2.0, 1.0/num_tasks) -1.0);
-    printf("which has a schedulability bound of %.1f%% for %d tasks.\n",
+    simprintf(sim, "which has a schedulability bound of %.1f%% for %d tasks.\n",
             100.0 * schedulability_bound, num_tasks);
 
     /* insert tasks in merit_list by increasing periods */
     /* If two tasks with equal period, order them by original sequence */
     for (i=1; i<=num_tasks; i++) {
-        task = taskset+i;
+        task = sim->taskset+i;
         task->merit = &(task->period);
-        insert_task(merit_list, *(task->merit), task);
-        insert_task(request_list, 0, task);
+        sim->batch[i-1].key = build_keyid(*(task->merit), task->sys_id);
+        sim->batch[i-1].value = task;
     }
+    insert_batch(sim, sim->merit_list, num_tasks, NULL);
+    requesttasks(sim, num_tasks);
 
-    puts("Critical set is composed of");
-    for (n=Head(merit_list); n!=NULL; n=Next(n)) {
+    simprintf(sim, "Critical set is composed of\n");
+    for (n=Head(sim->merit_list); n!=NULL; n=Next(sim->merit_list,n)) {
         task = GetValue(n);
         task_load += (float )task->cpu_time / (float )task->period;
         if (task_load <schedulability_bound) {
             critical_task_load= task_load;
-            printf("\t%s,\n", task->name);
+            simprintf(sim, "\t%s,\n", task->name);
         }
     }
-    printf("which accounts for a critical load of %.1f%%, over a total system load of %.1f%%\n",
+    simprintf(sim, "which accounts for a critical load of %.1f%%, over a total system load of %.1f%%\n",
             100.0 * critical_task_load, 100.0 * task_load);
-    if (task_load<=schedulability_bound) {
-        printf("So, the whole task set IS");
+    if (task_load<=schedulability_bound && !sim->ts->constrained) {
+        simprintf(sim, "So, the whole task set IS");
     } else {
         if (task_load>1.0)
-            printf("WARNING: the whole task set IS NOT");
+            simprintf(sim, "WARNING: the whole task set IS NOT");
         else
-            printf("WARNING: the whole task set MAY NOT be");
+            simprintf(sim, "WARNING: the whole task set MAY NOT be");
     }
-    printf(" schedulable under RM\n\n");
+    simprintf(sim, " schedulable under RM\n\n");
 }
 
-void monotonic_rate_end(void) {
+void monotonic_rate_end(Sim sim) {
 
-    FreeList(deadline_list); deadline_list = NULL;
+    FreeList(sim->deadline_list); sim->deadline_list = NULL;
+
+}
+
+/*
+ * Response time analysis: the worst case response time R of a task is
+ * that of an instance released at the same time as all the tasks before
+ * it in merit_list (the critical instant), the least fixed point of
+ *      R = C + sum of ceil(R/Tj)*Cj over those tasks
+ * found by iterating from R = C until it converges or passes the
+ * deadline. Each iteration is O(n), and their number does not depend on
+ * the hyperperiod.
+ * With jitter Jj is added to R in the ceiling, Ji to the response of the
+ * task itself, and the tasks of the same period after it count as well
+ * (a task keeps the processor against those of its same period).
+ *
+ * Without offsets nor jitter the test is exact, and the first deadline
+ * failure is that of the first instance of the task with the earliest
+ * deadline among those that do not meet it, so the verdict is given
+ * without simulating (even if that deadline is after the time range).
+ * With them it is only a sufficient test, as the tasks are
+ * not released at the same time.
+ * returns TRUE if the verdict is known
+ */
+int monotonic_rate_analysis(Sim sim) {
+    Node n;
+    Task task, hp;
+    Time r, w, deadline;
+    int i, j, ntasks, missed = 0;
+    int steady = sim->ts->steady;
+
+    /* the tasks in merit_list order */
+    ntasks = 0;
+    for (n=Head(sim->merit_list); n!=NULL; n=Next(sim->merit_list,n))
+        sim->batch[ntasks++].value = GetValue(n);
+
+    sim->failtask = NULL;
+    simprintf(sim, "Worst case response times under RM\n");
+    for (i=0; i<ntasks; i++) {
+        task = sim->batch[i].value;
+        deadline = task->reldeadline;
+        r = task->cpu_time;
+        do {
+            w = r;
+            r = task->cpu_time;
+            for (j=0; j<ntasks; j++) {
+                hp = sim->batch[j].value;
+                if (j > i && (!steady || hp->period != task->period))
+                    break;
+                if (j != i)
+                    r += (w+hp->jitter+hp->period-1)/hp->period * hp->cpu_time;
+            }
+        } while (r != w && task->jitter+r <= deadline);
+        r += task->jitter;
+        if (r <= deadline) {
+            simprintf(sim, "\t%s: %lld, slack %lld\n", task->name, r, deadline-r);
+        } else {
+            simprintf(sim, "\t%s: over %lld, misses its deadline\n", task->name, deadline);
+            /* the earliest deadline, as in deadline_list */
+            if (missed++ == 0 || deadline < sim->failtime
+                || (deadline == sim->failtime && task->sys_id < sim->failtask->sys_id)) {
+                sim->failtask = task;
+                sim->failtime = deadline;
+            }
+        }
+    }
+    if (missed == 0)
+        simprintf(sim, "By response time analysis, the whole task set IS");
+    else if (steady)
+        simprintf(sim, "By response time analysis (sufficient with offsets or jitter), the whole task set MAY NOT be");
+    else
+        simprintf(sim, "By response time analysis, the whole task set IS NOT");
+    simprintf(sim, " schedulable under RM\n\n");
+    return !steady || missed == 0;
+}
 
+/*
+ * Sufficient tests of the load under RM, from the cheapest: the bound of
+ * Liu and Layland n(2^(1/n)-1), the hyperbolic bound (the product of the
+ * Ui+1 is not over 2) and the bound K(2^(1/K)-1) of K harmonic chains
+ * (sets of periods that divide each other), 100% for a single chain.
+ * The chains are formed greedily along merit_list, so there may be more
+ * of them than needed, which only lowers the bound.
+ * They hold with offsets, but not with jitter nor with deadlines before
+ * the end of the period.
+ * returns the tier that proves the task set schedulable, or NOTIER
+ */
+int monotonic_rate_bounds(Sim sim) {
+    Node n;
+    Task task;
+    Time tmax = 0, c = 0;
+    double load = 0.0, product = 1.0, u;
+    int i, chains = 0, ntasks = sim->num_tasks;
+
+    if (sim->ts->constrained)
+        return NOTIER;
+    /* the last period of each chain is kept in sim->batch */
+    for (n=Head(sim->merit_list); n!=NULL; n=Next(sim->merit_list,n)) {
+        task = GetValue(n);
+        if (task->jitter)
+            return NOTIER;
+        u = (double) task->cpu_time / task->period;
+        load += u;
+        product *= u+1.0;
+        for (i=0; i<chains && task->period%sim->batch[i].key.key != 0; i++)
+            ;
+        if (i == chains)
+            chains++;
+        sim->batch[i].key.key = tmax = task->period;
+    }
+    if (load <= ntasks * (pow(2.0, 1.0/ntasks) - 1.0) - LOADEPSILON)
+        return UTILIZATION;
+    if (product <= 2.0 - LOADEPSILON)
+        return HYPERBOLIC;
+    if (chains == 1) {
+        /* exact: all the periods divide the last one */
+        for (n=Head(sim->merit_list); n!=NULL; n=Next(sim->merit_list,n)) {
+            task = GetValue(n);
+            c += tmax/task->period * task->cpu_time;
+        }
+        return (c <= tmax)? HARMONIC : NOTIER;
+    }
+    if (load <= chains * (pow(2.0, 1.0/chains) - 1.0) - LOADEPSILON)
+        return HARMONIC;
+    return NOTIER;
 }
 /****************************************************************************/
 
@@ -535,35 +1276,189 @@ void monotonic_rate_end(void) {
 *    Earliest-Deadline-First (EDF) algorithm
 *****************************************************************************/
 
-void earliest_deadline_init(void)
+void earliest_deadline_init(Sim sim)
 {
     Task task;
     float task_load = 0.0;
     int i;
 
-    printf("which has a schedulability bound of 100%%\n");
+    simprintf(sim, "which has a schedulability bound of 100%%\n");
 
     /* in the EDF case, 'deadline_list' is the same as 'merit_list' */
-    deadline_list = merit_list;
+    sim->deadline_list = sim->merit_list;
 
     /* insert tasks in merit_list by increasing deadlines */
-    for (i=1; i<=num_tasks; i++) {
-        task=taskset+i;
+    for (i=1; i<=sim->num_tasks; i++) {
+        task=sim->taskset+i;
         task->merit = &(task->deadline);
         task_load += (float )task->cpu_time / (float )task->period;
-        insert_task(request_list, 0, task);
+        sim->batch[i-1].value = task;
     }
+    requesttasks(sim, sim->num_tasks);
 
-    printf("Total system task load = %.1f%%\n", 100.0 * task_load);
-    if(task_load<=1.0)
-        printf("So, the whole task set IS");
+    simprintf(sim, "Total system task load = %.1f%%\n", 100.0 * task_load);
+    if(task_load>1.0)
+        simprintf(sim, "WARNING: the whole task set IS NOT");
+    else if(sim->ts->constrained)   /* the load is not enough then */
+        simprintf(sim, "WARNING: the whole task set MAY NOT be");
     else
-        printf("WARNING: the whole task set IS NOT");
-    printf(" schedulable under EDF\n\n");
+        simprintf(sim, "So, the whole task set IS");
+    simprintf(sim, " schedulable under EDF\n\n");
+}
+
+void earliest_deadline_end(Sim sim) {
+    sim->deadline_list = NULL;
+}
+
+/*
+ * processor demand h(t): execution time of the instances released from 0
+ * on (all tasks at the same time) with their deadline up to t. A task
+ * with jitter may be released that much later, so it counts as if its
+ * deadline was that much shorter
+ */
+Time processordemand(Sim sim, Time t) {
+    Task task;
+    Time d, h = 0;
+    int i;
+
+    for (i=1; i<=sim->num_tasks; i++) {
+        task = sim->taskset+i;
+        d = task->reldeadline - task->jitter;
+        if (t >= d)
+            h += ((t-d)/task->period + 1) * task->cpu_time;
+    }
+    return h;
+}
+
+/* the latest deadline of those instances before t (0 if there is none) */
+Time deadlinebefore(Sim sim, Time t) {
+    Task task;
+    Time d, latest = 0;
+    int i;
+
+    for (i=1; i<=sim->num_tasks; i++) {
+        task = sim->taskset+i;
+        d = task->reldeadline - task->jitter;
+        if (t > d) {
+            d += (t-d-1)/task->period * task->period;
+            if (d > latest)
+                latest = d;
+        }
+    }
+    return latest;
 }
 
-void earliest_deadline_end(void) {
-    deadline_list = NULL;
+/*
+ * Quick Processor-demand Analysis (Zhang and Burns): a task set with a
+ * load up to 100% is schedulable under EDF if and only if h(t) <= t at
+ * every deadline t in the synchronous busy period L (the first instant
+ * the processor is idle after releasing all tasks at 0), or before
+ *      La = max(Di, sum of (Ti-Di)*Ci/Ti / (1-load))
+ * if that comes first. Instead of checking all of them, QPA goes back
+ * from the last deadline before L: from t to h(t) if h(t) < t, as there
+ * is no failure in between, or else to the deadline before t, until h(t)
+ * is not over the shortest deadline. That takes a few points instead of
+ * the deadlines of the hyperperiod.
+ *
+ * Without offsets nor jitter the test is exact, otherwise only sufficient.
+ * The first failure of an unschedulable set is found by simulating, as it
+ * is before the point QPA stops at.
+ * returns TRUE if the task set is schedulable
+ */
+int earliest_deadline_analysis(Sim sim) {
+    Task task;
+    Time c = 0, w, busy, dmin = MAXTIME, t, h = 0;
+    double load = 0.0, la = 0.0;
+    int i, points = 0;
+
+    for (i=1; i<=sim->num_tasks; i++) {
+        task = sim->taskset+i;
+        c += task->cpu_time;
+        load += (double) task->cpu_time / task->period;
+        la += (double) (task->period-task->reldeadline+task->jitter) * task->cpu_time / task->period;
+        if (task->reldeadline-task->jitter < dmin)
+            dmin = task->reldeadline-task->jitter;
+    }
+    simprintf(sim, "Processor demand analysis (QPA)\n");
+    if (load > 1.0+1e-9) {
+        simprintf(sim, "\tthe load is over 100%%\n");
+        simprintf(sim, "By processor demand analysis, the whole task set IS NOT schedulable under EDF\n\n");
+        return FALSE;
+    }
+    /* La, only if the load is under 100% */
+    if (load < 1.0-1e-9) {
+        la /= 1.0-load;
+        for (i=1; i<=sim->num_tasks; i++) {
+            if ((sim->taskset+i)->reldeadline > la)
+                la = (sim->taskset+i)->reldeadline;
+        }
+    } else {
+        la = MAXTIME;
+    }
+
+    /* busy period: w = sum of ceil(w/Ti)*Ci from the sum of all Ci */
+    for (busy = c; busy < la; busy = w) {
+        w = 0;
+        for (i=1; i<=sim->num_tasks; i++) {
+            task = sim->taskset+i;
+            w += (busy+task->period-1)/task->period * task->cpu_time;
+        }
+        if (w == busy)
+            break;
+    }
+    if (busy > la)
+        busy = (Time) la;
+
+    t = deadlinebefore(sim, busy);
+    while (t > 0) {
+        h = processordemand(sim, t);
+        points++;
+        if (h > t || h <= dmin)
+            break;
+        t = (h < t)? h : deadlinebefore(sim, t);
+    }
+    simprintf(sim, "\tbusy period %lld, demand checked at %d of its deadlines\n", busy, points);
+    if (t > 0 && h > t) {
+        simprintf(sim, "\tat %lld the demand is %lld\n", t, h);
+        if (sim->ts->steady)
+            simprintf(sim, "By processor demand analysis (sufficient with offsets or jitter), the whole task set MAY NOT be");
+        else
+            simprintf(sim, "By processor demand analysis, the whole task set IS NOT");
+        simprintf(sim, " schedulable under EDF\n\n");
+        return FALSE;
+    }
+    simprintf(sim, "By processor demand analysis, the whole task set IS schedulable under EDF\n\n");
+    sim->failtask = NULL;
+    return TRUE;
+}
+
+/*
+ * Sufficient test of the load under EDF: the density, the sum of the
+ * Ci/Di, is not over 100%. With deadlines at the end of the period it is
+ * the load, and then the test is exact (checked in integers over the
+ * hyperperiod if it is known). It holds with offsets, but not with jitter.
+ * returns the tier that proves the task set schedulable, or NOTIER
+ */
+int earliest_deadline_bounds(Sim sim) {
+    Task task;
+    Time c = 0, lcm = sim->ts->lcm;
+    double density = 0.0;
+    int i;
+
+    for (i=1; i<=sim->num_tasks; i++) {
+        task = sim->taskset+i;
+        if (task->jitter)
+            return NOTIER;
+        density += (double) task->cpu_time / task->reldeadline;
+    }
+    if (!sim->ts->constrained && lcm > 0 && lcm <= MAXTIME/sim->num_tasks) {
+        for (i=1; i<=sim->num_tasks; i++) {
+            task = sim->taskset+i;
+            c += lcm/task->period * task->cpu_time;
+        }
+        return (c <= lcm)? UTILIZATION : NOTIER;
+    }
+    return (density <= 1.0 - LOADEPSILON)? UTILIZATION : NOTIER;
 }
 
 /****************************************************************************/
@@ -572,59 +1467,132 @@ void earliest_deadline_end(void) {
 *
 *    least laxity algorithm
 *****************************************************************************/
-void least_laxity_init(void) {
+void least_laxity_init(Sim sim) {
+    laxityinit(sim, "LLF");
+}
+
+/* common to LLF and MLLF, 'name' is the one in the messages */
+void laxityinit(Sim sim, char *name) {
     Task task;
     float task_load=0.0;
     int i;
 
-    printf("which has a schedulability bound of 100%%\n");
+    simprintf(sim, "which has a schedulability bound of 100%%\n");
 
     /* in the LLF case, 'deadline_list' is not the same as 'merit_list' */
-    deadline_list = NewList();
+    sim->deadline_list = NewList();
     //deadline_id= 'D';
 
-    for(i=1; i<=num_tasks; i++) {
-        task = taskset+i;
+    for(i=1; i<=sim->num_tasks; i++) {
+        task = sim->taskset+i;
         task->merit = &(task->laxity);
         task_load += (float )task->cpu_time / (float )task->period;
-        insert_task(merit_list, *task->merit, task);
-        insert_task(request_list, 0, task);
+        sim->batch[i-1].key = build_keyid(*task->merit, task->sys_id);
+        sim->batch[i-1].value = task;
     }
-    printf("Total system task load = %.1f%%\n", 100.0 * task_load);
-
-    if (task_load<=1.0)
-        printf("So, the whole task set IS");
+    insert_batch(sim, sim->merit_list, sim->num_tasks, NULL);
+    laxityqueues(sim, &sim->merit_list, 1);
+    requesttasks(sim, sim->num_tasks);
+    simprintf(sim, "Total system task load = %.1f%%\n", 100.0 * task_load);
+
+    if (task_load>1.0)
+        simprintf(sim, "WARNING: the whole task set IS NOT");
+    else if (sim->ts->constrained)
+        simprintf(sim, "WARNING: the whole task set MAY NOT be");
     else
-        printf("WARNING: the whole task set IS NOT");
-    printf(" schedulable under LLF\n\n");
+        simprintf(sim, "So, the whole task set IS");
+    simprintf(sim, " schedulable under %s\n\n", name);
 }
 
-Task least_laxity(void) {
+Task least_laxity(Sim sim) {
     Task least;
 
-    /* all tasks (except 'current') now have one less 'laxity' unit */
-    if ((least=getleastlaxityandupdate(merit_list)) ==idletask)
-        return idletask;
-    else if (current== idletask)
+    /* all READY tasks now have one less 'laxity' unit */
+    sim->decrements++;
+    if ((least=getleastlaxity(sim, 0)) ==sim->idletask)
+        return sim->idletask;
+    else if (sim->current== sim->idletask)
         return least;
     else /* current task prevails other tasks with same merit */
-        return (*least->merit == *current->merit)? current : least;
+        return (tasklaxity(sim, least) == tasklaxity(sim, sim->current))? sim->current : least;
+}
+
+
+void least_laxity_end(Sim sim) {
+    FreeList(sim->deadline_list); sim->deadline_list = NULL;
+    FreeList(sim->laxity_q[0]); sim->laxity_q[0] = NULL;
+}
+
+Time least_laxity_horizon(Sim sim) {
+    return getlaxityhorizon(sim, 0);
+}
+
+void least_laxity_elapse(Sim sim, Time ticks) {
+    sim->decrements += ticks;
+}
+
+/****************************************************************************/
+
+/*
+*
+*    modified least laxity algorithm
+*
+* LLF switches between tasks of the same laxity at every other tick, as
+* the laxity of the one that waits goes below that of the one that runs.
+* MLLF (Oh and Yang) lets the running task go on while another one only
+* has a lower laxity. The task with the least laxity is chosen again at
+* the scheduling points: the ticks where some task is released (whatever
+* the laxity of the one released, so a task that was already waiting may
+* preempt the running one then), the completion of the running task, and
+* when a waiting task has no laxity left (it has to run from then on to
+* meet its deadline). Among the tasks with the least laxity the one with
+* the earliest deadline is chosen, as it is the one that frees the
+* processor first for the others.
+*****************************************************************************/
+void modified_least_laxity_init(Sim sim) {
+    laxityinit(sim, "MLLF");
+}
+
+Task modified_least_laxity(Sim sim) {
+    Task least, current = sim->current;
+    Time ll;
+
+    /* all READY tasks now have one less 'laxity' unit */
+    sim->decrements++;
+    if ((least=getleastlaxity(sim, 0)) ==sim->idletask  ||  least == current)
+        return least;
+    ll = tasklaxity(sim, least);
+    if (current == sim->idletask)
+        return getearliestdeadline(sim, least);
+    /* current task prevails other tasks with same merit */
+    if (ll == tasklaxity(sim, current))
+        return current;
+    /* and with a lower one, except at a release or if they have to run */
+    if (sim->releases == 0  &&  ll > 0)
+        return current;
+    return getearliestdeadline(sim, least);
 }
 
+/*
+ * number of ticks until the first READY task gets to zero laxity (and
+ * preempts current) or, if it is already there, to a negative one
+ */
+Time modified_least_laxity_horizon(Sim sim) {
+    Node n;
+    Time lax;
 
-void least_laxity_end(void) {
-    FreeList(deadline_list); deadline_list = NULL;
+    if ((n=Head(sim->laxity_q[0])) == NULL)
+        return MAXTIME;
+    lax = get_key(GetKey(n)) - sim->decrements;
+    return (lax > 0)? lax : lax+1;
 }
 
 /*
  *
  *   Maximum-Urgency-First (MUF) Scheduling Algorithm
  ****************************************************************************/
-List high_crit_l, low_crit_l;
-//char high_crit_id,low_crit_id;
-Task first;
 
-void maximum_urgency_first_init(void) {
+void maximum_urgency_first_init(Sim sim) {
     Node n;
     List temp_list;
 //    char temp_id;
@@ -632,108 +1600,236 @@ void maximum_urgency_first_init(void) {
     float critical_task_load = 0.0, task_load = 0.0, temp = 0.0, load;
     int i, critical_set = TRUE;
 
-    printf("which has a schedulability bound of 100%%\n");
+    simprintf(sim, "which has a schedulability bound of 100%%\n");
 
     /* in the MUF case, 'deadline_list' is not the same as 'merit_list' */
-    deadline_list = NewList();// deadline_id= 'D';
+    sim->deadline_list = NewList();// deadline_id= 'D';
     temp_list = NewList();// temp_id= 'T';
-    high_crit_l = merit_list;// high_crit_id= 'H';
-    low_crit_l = NewList(); //low_crit_id= 'L';
+    sim->high_crit_l = sim->merit_list;// high_crit_id= 'H';
+    sim->low_crit_l = NewList(); //low_crit_id= 'L';
 
-    for (i=1; i<=num_tasks; i++) {
-        task = taskset+i;
+    for (i=1; i<=sim->num_tasks; i++) {
+        task = sim->taskset+i;
         task->merit = &task->laxity;
         /* use temp_list to order tasks by increasing periods */
-        insert_task(temp_list, task->period, task);
-        insert_task(request_list, 0, task);
+        sim->batch[i-1].key = build_keyid(task->period, task->sys_id);
+        sim->batch[i-1].value = task;
     }
+    insert_batch(sim, temp_list, sim->num_tasks, NULL);
+    requesttasks(sim, sim->num_tasks);
 
     /* insert tasks in both (high_crit_l and low_crit_l) lists */
-    puts("Critical set is composed of"); /* the first 'n' tasks in 'high_crit_l'
+    simprintf(sim, "Critical set is composed of\n"); /* the first 'n' tasks in 'high_crit_l'
                                            * with combined load less than 100% */
-    for (n=Head(temp_list); n!=NULL; n=Next(n)) {
+    for (n=Head(temp_list); n!=NULL; n=Next(temp_list,n)) {
         task=GetValue(n);
         task_load+=(load= (float )task->cpu_time / (float )task->period);
 
         if (task->criticality ==HIGH){
             if((temp+=load)<=1.0  &&  critical_set==TRUE){
                 critical_task_load = temp;
-                printf("\t%s,\n", task->name);
-                insert_task(high_crit_l, task->period, task);
+                simprintf(sim, "\t%s,\n", task->name);
+                insert_task(sim->high_crit_l, task->period, task);
             } else {
                 critical_set = FALSE;
-                printf("WARNING at %d: Highly critical task %c (\"%s\"),\
-                    found NOT Schedulable!!", sys_time, task->sys_id, task->name);
-                insert_task(low_crit_l, task->period, task);
+                simprintf(sim, "WARNING at %lld: Highly critical task %c (\"%s\"),\
+                    found NOT Schedulable!!", sim->sys_time, idchar(task->sys_id), task->name);
+                insert_task(sim->low_crit_l, task->period, task);
             }
 
         } else {    /* task->criticality ==LOW */
-            insert_task(low_crit_l, task->period, task);
+            insert_task(sim->low_crit_l, task->period, task);
         }
     }
     FreeList(temp_list);
+    laxityqueues(sim, &sim->high_crit_l, 2);
 
-    printf("which accounts for a critical load of %.1f%%, over a total system load of %.1f%%\n",
+    simprintf(sim, "which accounts for a critical load of %.1f%%, over a total system load of %.1f%%\n",
             100.0 * critical_task_load, 100.0 * task_load);
     if (task_load<=1.0)
-        printf("So, the whole task set MAY BE");
+        simprintf(sim, "So, the whole task set MAY BE");
     else
-        printf("WARNING: the whole task set IS NOT");
-    printf(" schedulable under MUF\n\n");
+        simprintf(sim, "WARNING: the whole task set IS NOT");
+    simprintf(sim, " schedulable under MUF\n\n");
 }
 
-Task maximum_urgency_first(void) {
+Task maximum_urgency_first(Sim sim) {
     Task least, leasth, leastl;
 
-    /* all tasks (except 'current') now have one less 'laxity' unit */
-    leasth = getleastlaxityandupdate(high_crit_l);
-    leastl = getleastlaxityandupdate(low_crit_l);
-    least = (leasth==idletask)? leastl : leasth;
+    /* all READY tasks now have one less 'laxity' unit */
+    sim->decrements++;
+    leasth = getleastlaxity(sim, 0);
+    leastl = getleastlaxity(sim, 1);
+    least = (leasth==sim->idletask)? leastl : leasth;
 
-    /* all tasks (except 'current') have one less 'laxity' time unit */
-    if (least==idletask)
-        return idletask;
-    else if (current== idletask)
+    if (least==sim->idletask)
+        return sim->idletask;
+    else if (sim->current== sim->idletask)
         return least;
     else /* current task prevails other tasks with same merit */
-        return (*least->merit == *current->merit)? current : least;
+        return (tasklaxity(sim, least) == tasklaxity(sim, sim->current))? sim->current : least;
 }
 
-void maximum_urgency_first_end(void) {
-    FreeList(deadline_list); deadline_list = NULL;
-    high_crit_l = NULL;
-    FreeList(low_crit_l); low_crit_l = NULL;
-
+void maximum_urgency_first_end(Sim sim) {
+    FreeList(sim->deadline_list); sim->deadline_list = NULL;
+    sim->high_crit_l = NULL;
+    FreeList(sim->low_crit_l); sim->low_crit_l = NULL;
+    FreeList(sim->laxity_q[0]); sim->laxity_q[0] = NULL;
+    FreeList(sim->laxity_q[1]); sim->laxity_q[1] = NULL;
 }
 
-/* returns idletask if 'l' is empty */
-Task getleastlaxityandupdate(List l) {
-    Task task, least;
-    Node n;
+Time maximum_urgency_first_horizon(Sim sim) {
+    Time th, tl;
 
-    least= idletask;
-    for (n=Head(l); n!=NULL; n=Next(n)) {
-        task = GetValue(n);
-        /* task->laxity(t) = task->deadline - t - task->remaining(t);
-         * but now(t)= now(t-1)+1,
-         * and task->remaining(t)=  task->remaining(t-1), if task!=current,
-         * ==> task->laxity(t) = task->laxity(t-1) -1;
-         *********************************************************************/
-        /* look out! task->laxity is decremented only if its state is READY, because of && */
-        if (task->state ==READY  &&  -- task->laxity<0) { /* if it's eligible... */
-            printf("At %d: task %c (\"%s\"), instance %d, will lose its deadline at %d\n",
-                sys_time, task->sys_id, task->name, task->instance, task->deadline);
-            task->state=BLOCKED;
-        }
-        if ((task->state ==READY || task->state ==RUNNING)  &&  task->laxity < least->laxity)
-                least=task;
-    }
-    return least;
+    th = getlaxityhorizon(sim, 0);
+    tl = getlaxityhorizon(sim, 1);
+    return (th < tl)? th : tl;
 }
 
-/* return the first READY or RUNNING task in the list */
-Task getfirstready(List l) {
-    Node p;
+void maximum_urgency_first_elapse(Sim sim, Time ticks) {
+    sim->decrements += ticks;
+}
+
+/*
+ * Laxity algorithms: the laxity of a READY task goes down by one unit each
+ * tick, and that of any other task stays the same. Instead of updating all
+ * of them, sim->decrements counts the units lost by any task that was READY
+ * all the time, and a READY task is in the laxity queue of its merit list
+ * with the key 'zero' = laxity + decrements (the decrements after which its
+ * laxity is 0), that does not change until it leaves the READY state. Ties
+ * are broken by the rank of the task in its merit list, the order in which
+ * the whole list used to be scanned.
+ */
+
+/* laxity of the task now */
+Time tasklaxity(Sim sim, Task task) {
+    return (task->laxity_h != NULL)? task->zero - sim->decrements : task->laxity;
+}
+
+/* the laxity of a READY task is kept in task->laxity from now on */
+void laxityleave(Sim sim, Task task) {
+    if (task->laxity_h != NULL) {
+        task->laxity = task->zero - sim->decrements;
+        delete_task(sim->laxity_q[task->laxq], &task->laxity_h);
+    }
+}
+
+/* a task that just got READY joins its laxity queue (if there are any) */
+void laxityenter(Sim sim, Task task) {
+    if (sim->laxity_q[0] != NULL && task != sim->idletask) {
+        task->zero = task->laxity + sim->decrements;
+        task->laxity_h = PQueueInsertHandle(sim->laxity_q[task->laxq],
+            build_keyid(task->zero, task->rank), task);
+    }
+}
+
+void changestate(Sim sim, Task task, enum state_e state) {
+    laxityleave(sim, task);
+    task->state = state;
+    if (state == READY)
+        laxityenter(sim, task);
+}
+
+/* a laxity queue for each of the n merit lists, that never change */
+void laxityqueues(Sim sim, List l[], int n) {
+    Task task;
+    Node p;
+    int q, rank;
+
+    for (q=0; q<n; q++) {
+        sim->laxity_q[q] = NewList();
+        rank = 0;
+        for (p=Head(l[q]); p!=NULL; p=Next(l[q],p)) {
+            task = GetValue(p);
+            task->laxq = q;
+            task->rank = rank++;
+            task->laxity_h = NULL;
+        }
+    }
+}
+
+/*
+ * the READY tasks of queue 'q' that just got a negative laxity are BLOCKED
+ * (in the order of their merit list), and the one with the least laxity
+ * among the rest and the running task (if it is in the same list) is
+ * returned. Returns idletask if there is none.
+ */
+Task getleastlaxity(Sim sim, int q) {
+    List l = sim->laxity_q[q];
+    Task task, least;
+    Node n;
+    int i, nfail;
+
+    for (nfail=0; (n=Head(l)) && get_key(GetKey(n)) < sim->decrements; nfail++) {
+        task = GetValue(n);
+        changestate(sim, task, BLOCKED);
+        sim->batch[nfail].key = build_keyid(task->rank, task->sys_id);
+        sim->batch[nfail].value = task;
+    }
+    if (nfail > 1)
+        sortbatch(sim->batch, sim->sorttmp, nfail);
+    for (i=0; i<nfail; i++) {
+        task = sim->batch[i].value;
+        simprintf(sim, "At %lld: task %c (\"%s\"), instance %d, will lose its deadline at %lld\n",
+            sim->sys_time, idchar(task->sys_id), task->name, task->instance, task->deadline);
+        taskfailure(sim, task);
+    }
+
+    least = (n=Head(l))? GetValue(n) : sim->idletask;
+    task = sim->current;
+    if (task->state == RUNNING  &&  task != sim->idletask  &&  task->laxq == q
+        && (least == sim->idletask  ||  task->laxity < tasklaxity(sim, least)
+            || (task->laxity == tasklaxity(sim, least) && task->rank < least->rank)))
+        least = task;
+    return least;
+}
+
+/*
+ * the READY task with the earliest deadline among those with the laxity of
+ * 'least' (the first one in its merit list if there are several)
+ */
+Task getearliestdeadline(Sim sim, Task least) {
+    List l = sim->laxity_q[least->laxq];
+    Task task;
+    Node n;
+
+    for (n=Head(l); n!=NULL && get_key(GetKey(n)) == least->zero; n=Next(l,n)) {
+        task = GetValue(n);
+        if (task->deadline < least->deadline)
+            least = task;
+    }
+    return least;
+}
+
+/*
+ * number of ticks until a READY task in queue 'q' either gets a laxity
+ * lower than current's (and preempts it) or a negative one (and gets
+ * BLOCKED). A READY task with a laxity already lower than current's belongs
+ * to a list that is not being served (MUF), so only the second case
+ * applies to it, and the first one of them is the one that fails first.
+ * returns MAXTIME if the queue is empty
+ */
+Time getlaxityhorizon(Sim sim, int q) {
+    List l = sim->laxity_q[q];
+    Node n;
+    Time lc, lax, t, least;
+
+    lc = tasklaxity(sim, sim->current);
+    least = MAXTIME;
+    for (n=Head(l); n!=NULL; n=Next(l,n)) {
+        lax = get_key(GetKey(n)) - sim->decrements;
+        t = (lax >= lc)? lax-lc+1 : lax+1;
+        if (t < least)
+            least = t;
+        if (lax >= lc)
+            break;
+    }
+    return least;
+}
+
+/* return the first READY or RUNNING task in the list */
+Task getfirstready(List l) {
+    Node p;
     Task task;  /* this variable must be used to cast the void *v in 'p' */
 
     p = Head(l);
@@ -741,7 +1837,7 @@ Task getfirstready(List l) {
      * ==> This sentence fails if the states are re-enum-bered <==
      *************************************************************/
     while (p!= NULL  &&  (task=GetValue(p))->state < READY)
-        p = Next(p);
+        p = Next(l,p);
 
     if (p==NULL)
         return NULL;
@@ -755,8 +1851,8 @@ void showtasklist(List l, char sys_id) {
     Node n;
 
     printf("%c |",sys_id);
-    for (n = Head(l); n != NULL; n = Next(n)) {
-        printf("%d('%c',", (int) GetKey(n), (task=GetValue(n))->sys_id);
+    for (n = Head(l); n != NULL; n = Next(l,n)) {
+        printf("%lld('%c',", get_key(GetKey(n)), idchar((task=GetValue(n))->sys_id));
         switch (task->state){
             case DEAD:     state='d'; break;
             case IDLE:     state='i'; break;
@@ -770,31 +1866,65 @@ void showtasklist(List l, char sys_id) {
     printf("NIL\n\n");
 }
 
-void showtaskset(void) {
+void showtaskset(FILE *out, TaskSet ts) {
     char tmp[MAXLINESIZE+1];
     Task task;
     int i, length;
 
-    printf("Task Set: %s\n", taskset_title);
-    printf("Number of tasks in the set: %d\n", num_tasks);
+    fprintf(out, "Task Set: %s\n", ts->title);
+    fprintf(out, "Number of tasks in the set: %d\n", ts->num_tasks);
 
-    puts("\n");
-    puts("Task Set Description");
-    puts("--------------------");
-    puts("Name                  Criticality  Period  ExecTime  Task Load");
-    for (i=num_tasks; i>=1; i--) {
-        length = strlen((task=taskset+i)->name);
+    fprintf(out, "\n\n");
+    fprintf(out, "Task Set Description\n");
+    fprintf(out, "--------------------\n");
+    fprintf(out, "Name                  Criticality  Period  ExecTime  Task Load%s%s\n",
+            ts->constrained? "  Deadline": "", ts->steady? "  Offset  Jitter": "");
+    for (i=ts->num_tasks; i>=1; i--) {
+        length = strlen((task=ts->tasks+i)->name);
         if (length>22) length=22;
         strncpy(tmp, task->name, 22);
         memset(tmp+length, ' ', 22-length);
         tmp[22]='\0';
 
-        printf("%s   %6s    ", tmp, task->criticality==HIGH? "high": "low");
-        printf("%5d   %6d    ", task->period, task->cpu_time);
-        printf("%6.1f%%\n", 100.0 * (float )task->cpu_time / (float )task->period);
+        fprintf(out, "%s   %6s    ", tmp, task->criticality==HIGH? "high": "low");
+        fprintf(out, "%5lld   %6lld    ", task->period, task->cpu_time);
+        fprintf(out, "%6.1f%%", 100.0 * (float )task->cpu_time / (float )task->period);
+        if (ts->constrained)
+            fprintf(out, "    %6lld", task->reldeadline);
+        if (ts->steady)
+            fprintf(out, "    %6lld  %6lld", task->offset, task->jitter);
+        fprintf(out, "\n");
     }
 }
 
+/* the idle task runs when no other can */
+void idletaskinit(Task idletask) {
+    idletask->sys_id = IDLEID;
+    idletask->name = "Idle Task";
+    idletask->state = READY;
+    idletask->deadline = 0;
+    idletask->laxity = MAXTIME;  /* maximum value a task can have */
+    idletask->laxity_h = NULL;
+    idletask->merit = &(idletask->deadline);
+}
+
+/* least common multiple of the periods (0 if larger than horizon) */
+Time hyperperiod(TaskSet ts) {
+    int i;
+    Time *t, tm;
+
+    t = malloc(ts->num_tasks*sizeof(Time));
+    if( t == NULL ) {
+            fprintf(stderr, "Not enough memory available\n");
+            exit(-1);
+    }
+    for(i=1;i<=ts->num_tasks;i++) t[i-1] = ts->tasks[i].period;
+    if( lcmvlimit(t,ts->num_tasks,horizon,&tm) != LCM_OK )
+        tm = 0;
+    free(t);
+    return tm;
+}
+
 /*
  * Read case info file
  */
@@ -808,29 +1938,39 @@ const char *keywordtable[] = {
     NULL
 };
 
-int readtaskset(char *fname) {
+TaskSet readtaskset(FILE *out, char *fname) {
     FILE *infile;
-    int  ikey,itask;
-    char *token;
-    int i,tm,*t;
-    static char tmp[MAXLINESIZE+1]; /* buffer to read in lines from configuration file */
+    int  ikey,itask,idindex;
+    char *token, *saveptr;
+    int i;
+    Time tm,omax;
+    char tmp[MAXLINESIZE+1]; /* buffer to read in lines from configuration file */
+    TaskSet ts;
+    Task taskset = NULL, idletask;
+    int num_tasks;
 
 
-    printf("Reading %s\n",fname);
+    if( out ) fprintf(out, "Reading %s\n",fname);
     if ((infile = fopen(fname, "rt" )) == NULL ) {
         fprintf(stderr, "Can't open configuration file %s\n", fname);
         exit(-1);
     }
+    if ((ts = malloc(sizeof(struct taskset_s))) == NULL) {
+        fprintf(stderr, "Not enough memory available\n");
+        exit(-1);
+    }
+    ts->title = strdup("");
+    ts->fname = fname;
 
     itask = 0;
     num_tasks = 0;
-    max_time = 0;
+    ts->max_time = 0;
     idindex = 0;
     while ( !feof(infile) ) {
         fgets(tmp, MAXLINESIZE-1, infile);
         if (tmp[0]==';' || tmp[0]=='*' || tmp[0] == '\n' || tmp[0] == '\r' )
             continue;
-        token=strtok(tmp," \t\n");
+        token=strtok_r(tmp," \t\n", &saveptr);
          if( token == NULL )
              continue;
         for(ikey=0;keywordtable[ikey];ikey++) {
@@ -843,39 +1983,31 @@ int readtaskset(char *fname) {
         }
         switch(ikey) {
         case 0: /* title */
-            token = strtok(NULL,"\n");
-            taskset_title = strdup(token);
+            token = strtok_r(NULL,"\n", &saveptr);
+            free(ts->title);
+            ts->title = strdup(token);
             break;
         case 1: /* tasks */
             if( num_tasks ) {
                 fprintf(stderr,"Number of tasks already specified\n");
                 exit(-1);
             }
-               token = strtok(NULL," \t\n");
+               token = strtok_r(NULL," \t\n", &saveptr);
             num_tasks = atoi(token);
             if ( num_tasks <= 0 ){
                 fprintf(stderr, "Invalid number of tasks\n");
                 exit(-1);
-            }
-            if ( num_tasks > 24){
-                fprintf(stderr, "Not enough id letters for all tasks\n");
-                exit(-1);
             }
              if((taskset = malloc((num_tasks+1)*sizeof(struct task_struct))) == NULL) {
                 fprintf(stderr, "Not enough memory available\n");
                 exit(-1);
             }
             idletask = (taskset+0);
-            idletask->sys_id = '.';
-            idletask->name = "Idle Task";
-            idletask->state = READY;
-            idletask->deadline = 0;
-            idletask->laxity = MAXINT;   /* maximum value a task can have */
-            idletask->merit = &(idletask->deadline);
+            idletaskinit(idletask);
             break;
         case 2: /* maxtime */
-            token = strtok(NULL," \t\n");
-            max_time=atoi(token);
+            token = strtok_r(NULL," \t\n", &saveptr);
+            ts->max_time=atoll(token);
             break;
         case 3: /* task */
             if( num_tasks == 0 ) {
@@ -887,25 +2019,48 @@ int readtaskset(char *fname) {
                 exit(-1);
             }
             i = num_tasks-itask; /* fill backwards (why?) */
-            if( idtable[idindex] == '\0' ) {
-                fprintf(stderr,"Run out of id chars\n");
-                exit(-1);
-            }
-            (taskset+i)->sys_id = idtable[idindex++];
+            (taskset+i)->sys_id = idindex++;
             (taskset+i)->state  =IDLE;
             (taskset+i)->instance = 0;
             (taskset+i)->cycles = 0;
-            token=strtok(NULL, " \t,");
+            (taskset+i)->deadline_h = NULL;
+            (taskset+i)->laxity_h = NULL;
+            (taskset+i)->deadline = 0;
+            (taskset+i)->laxity = 0;
+            token=strtok_r(NULL, " \t,", &saveptr);
             (taskset+i)->name = strdup(token);
-            token=strtok(NULL, " \t,");
+            token=strtok_r(NULL, " \t,", &saveptr);
             (taskset+i)->criticality= strcasecmp(token, "HIGH")?  LOW: HIGH;
-            (taskset+i)->period = atoi(strtok(NULL, " \t,"));
-            (taskset+i)->cpu_time = (taskset+i)->remaining= atoi(strtok(NULL, "."));
+            (taskset+i)->period = atoll(strtok_r(NULL, " \t,", &saveptr));
+            (taskset+i)->cpu_time = (taskset+i)->remaining= atoll(strtok_r(NULL, " \t,.\n", &saveptr));
             if((taskset+i)->period <0 || (taskset+i)->cpu_time < 1
                 || (taskset+i)->cpu_time > (taskset+i)->period ) {
                     fprintf(stderr,"Number of tasks must be specified before tasks\n");
                     exit(-1);
             }
+            /* optional attributes: offset=<time> jitter=<time> deadline=<time> */
+            (taskset+i)->offset = (taskset+i)->jitter = 0;
+            (taskset+i)->reldeadline = (taskset+i)->period;
+            while ((token=strtok_r(NULL, " \t,\n", &saveptr)) != NULL) {
+                if (strncasecmp(token, "offset=", 7) == 0)
+                    (taskset+i)->offset = atoll(token+7);
+                else if (strncasecmp(token, "jitter=", 7) == 0)
+                    (taskset+i)->jitter = atoll(token+7);
+                else if (strncasecmp(token, "deadline=", 9) == 0)
+                    (taskset+i)->reldeadline = atoll(token+9);
+            }
+            if ((taskset+i)->offset < 0 || (taskset+i)->jitter < 0
+                || (taskset+i)->cpu_time+(taskset+i)->jitter > (taskset+i)->period) {
+                    fprintf(stderr,"Invalid offset or jitter for task %s\n", (taskset+i)->name);
+                    exit(-1);
+            }
+            /* constrained deadlines: the instances of a task do not overlap */
+            if ((taskset+i)->reldeadline < (taskset+i)->cpu_time+(taskset+i)->jitter
+                || (taskset+i)->reldeadline > (taskset+i)->period) {
+                    fprintf(stderr,"Invalid deadline for task %s\n", (taskset+i)->name);
+                    exit(-1);
+            }
+            (taskset+i)->arrival = (taskset+i)->offset;
             itask++;
             break;
         case 4: /* end */
@@ -920,60 +2075,858 @@ endfile:
         fprintf(stderr, "Not enough tasks specified\n");
         exit(-1);
     }
+    ts->num_tasks = num_tasks;
+    ts->tasks = taskset;
+
+    tm = hyperperiod(ts);
+    ts->lcm = tm;
+    ts->steady = FALSE;
+    ts->constrained = FALSE;
+    ts->capped = FALSE;
+    omax = 0;
+    for (i=1; i<=num_tasks; i++) {
+        if (taskset[i].offset || taskset[i].jitter)
+            ts->steady = TRUE;
+        if (taskset[i].reldeadline < taskset[i].period)
+            ts->constrained = TRUE;
+        if (taskset[i].offset > omax)
+            omax = taskset[i].offset;
+    }
+    ts->omax = omax;
+    fclose(infile);
 
-    t = malloc(num_tasks*sizeof(int));
-    if( t == NULL ) {
-            fprintf(stderr, "Not enough memory available\n");
-            exit(-1);
+    if( tm == 0 && ts->max_time == 0 ) {
+        if( horizon )
+            fprintf(stderr,"Least common multiple of the periods is larger than %lld"
+                    " (use maxtime or -t)\n", horizon);
+        else
+            fprintf(stderr,"Least common multiple of the periods does not fit"
+                    " in 64 bits (use maxtime)\n");
+        cleartaskset(ts);
+        return NULL;
     }
-    for(i=1;i<=num_tasks;i++) t[i-1] = taskset[i].period;
-    tm = lcmv(t,num_tasks);
-    free(t);
-    if( max_time == 0 ) {
-        max_time = tm;
-    } else if ( max_time < tm ) {
-        fprintf(stderr,"Time range is %d but least common multiple is %d\n",
-              max_time,tm);
+    if( tm == 0 ) {
+        /* so the time range given is simulated, but no steady state */
+        fprintf(stderr,"Time range is %lld but least common multiple is larger than %lld\n",
+              ts->max_time,horizon? horizon : MAXTIME);
+        ts->steady = FALSE;
+    } else if( ts->max_time == 0 && ts->steady ) {
+        /* an upper limit: it stops as soon as the state repeats */
+        if( (num_tasks+2) > ((horizon? horizon : MAXTIME-1)-omax)/tm ) {
+            ts->max_time = horizon? horizon : MAXTIME-1;
+            ts->capped = TRUE;
+        } else
+            ts->max_time = omax + (num_tasks+2)*tm;
+    } else if( ts->max_time == 0 ) {
+        ts->max_time = tm;
+    } else if ( ts->max_time < tm ) {
+        fprintf(stderr,"Time range is %lld but least common multiple is %lld\n",
+              ts->max_time,tm);
     }
-    fclose(infile);
 
-    /* allocate and init output timeline */
-    /* two chars more: one for zero and the other for the last '\0' */
+    if( verbose && out ) fprintf(out, "Done.\n");
+    return ts; /* if it could get this point, then all was OK */
+}
 
-    timeline_history = malloc(max_time+2);
 
-    if ( !timeline_history ) {
-        fprintf(stderr, "Not enough memory available for allocating timeline");
+void cleartaskset(TaskSet ts) {
+    int i;
+
+    if( ts == NULL )
+        return;
+    if( ts->title ) {
+        free(ts->title);
+        ts->title = NULL;
+    }
+    for(i=1;i<=ts->num_tasks;i++) {
+        free((ts->tasks+i)->name);
+    }
+    free(ts->tasks);
+    free(ts);
+}
+
+/*
+ * create a simulation context for the task set: it gets its own copy of
+ * the tasks (names are shared) and its own output timeline
+ */
+Sim newsim(TaskSet ts) {
+    Sim sim;
+    size_t size = (ts->num_tasks+1)*sizeof(struct task_struct);
+
+    if ((sim = calloc(1, sizeof(struct sim_s))) == NULL
+        || (sim->taskset = malloc(size)) == NULL) {
+        fprintf(stderr, "Not enough memory available\n");
+        exit(-1);
+    }
+    memcpy(sim->taskset, ts->tasks, size);
+    sim->idletask = sim->taskset+0;
+    sim->idletask->merit = &(sim->idletask->deadline);
+    sim->current = sim->idletask;
+    sim->ts = ts;
+    sim->out = stdout;
+    sim->num_tasks = ts->num_tasks;
+    sim->max_time = ts->max_time;
+
+    /* allocate output timeline (not needed for a verdict) */
+    /* it grows with the number of context switches */
+
+    if( !verdict ) {
+        sim->maxsegments = INITIALSEGMENTS;
+        sim->timeline = malloc(sim->maxsegments*sizeof(struct segment_s));
+
+        if ( !sim->timeline ) {
+            fprintf(stderr, "Not enough memory available for allocating timeline");
+            exit(-1);
+        }
+    }
+
+    /* the states saved grow as needed up to (max_time-omax)/lcm+1 */
+    if( ts->steady )
+        growstates(sim);
+
+    /* init system lists */
+    sim->merit_list = NewList();
+    sim->request_list = NewList();
+    sim->batch = malloc((sim->num_tasks+1)*sizeof(Entry));
+    sim->sorttmp = malloc((sim->num_tasks+1)*sizeof(Entry));
+    sim->handles = malloc((sim->num_tasks+1)*sizeof(Handle));
+    if ( !sim->batch || !sim->sorttmp || !sim->handles ) {
+        fprintf(stderr, "Not enough memory available\n");
         exit(-1);
     }
-    memset(timeline_history, '\0', max_time+2);
 
-    if( verbose ) printf("Done.\n");
-    return TRUE; /* if it could get this point, then all was OK */
+    return sim;
+}
+
+void freesim(Sim sim) {
+
+    FreeList(sim->merit_list);
+    FreeList(sim->request_list);
+    free(sim->timeline);
+    free(sim->states);
+    free(sim->snapshots);
+    free(sim->statetable);
+    free(sim->batch);
+    free(sim->sorttmp);
+    free(sim->handles);
+    free(sim->taskset);
+    free(sim);
 }
 
+/*
+ * A load over 100% fails under any algorithm: in a synchronous task set
+ * some instance misses its deadline by the overload point (see below).
+ */
+int overloaded(Sim sim) {
+    Task task;
+    double load = 0.0;
+    int i;
+
+    if (sim->ts->steady)
+        return FALSE;
+    for (i=1; i<=sim->num_tasks; i++) {
+        task = sim->taskset+i;
+        load += (double) task->cpu_time / task->period;
+    }
+    return load > 1.0+LOADEPSILON;
+}
 
-void cleartaskset(Task taskset, int n) {
+/*
+ * Overload point: the first deadline of a synchronous task set at which
+ * the processor demand is over the time. With a load over 100% there is
+ * one, and some instance with its deadline up to it misses, whatever the
+ * algorithm, so the first failure is found by simulating up to it.
+ * It is not after the hyperperiod, where the demand is the load times it,
+ * nor after sum(C)/(U-1), as the demand at t is over U*t-sum(C). With a
+ * load just over 100% that is still far, so the deadlines are walked up
+ * to 'limit' at most.
+ * returns 0 if it is after 'limit' (0 = only those bounds)
+ */
+Time overloadpoint(Sim sim, Time limit) {
+    Task task;
+    Time t = 0, d, next, c = 0;
+    double load = 0.0, bound;
     int i;
 
-    if( taskset == NULL )
+    for (i=1; i<=sim->num_tasks; i++) {
+        task = sim->taskset+i;
+        c += task->cpu_time;
+        load += (double) task->cpu_time / task->period;
+    }
+    /* with some room for the rounding of the load */
+    bound = c/(load-1.0)*(1.0+1e-6) + 1.0;
+    if (sim->ts->lcm > 0 && sim->ts->lcm < bound)
+        bound = sim->ts->lcm;
+    if (limit == 0 || limit > bound)
+        limit = (bound < MAXTIME)? (Time) bound : MAXTIME;
+
+    do {
+        next = MAXTIME;
+        for (i=1; i<=sim->num_tasks; i++) {
+            task = sim->taskset+i;
+            d = task->reldeadline;
+            if (t >= d)
+                d += ((t-d)/task->period+1)*task->period;
+            if (d < next)
+                next = d;
+        }
+        t = next;
+        if (t > limit)
+            return 0;
+    } while (processordemand(sim, t) <= t);
+    return t;
+}
+
+/*
+ * tiers of the admission pipeline before the exact analysis: the overload
+ * (only if 'anyfailure', as it gives no failure instant by itself) and the
+ * bounds of the algorithm. An overload leaves the idle task in
+ * sim->failtask.
+ * returns the tier that decides, or NOTIER
+ */
+int loadtier(Sim sim, Alg palg, int anyfailure) {
+    sim->failtask = NULL;
+    if (anyfailure && overloaded(sim)) {
+        sim->failtask = sim->idletask;
+        return UTILIZATION;
+    }
+    if (palg->bounds != NULL)
+        return (palg->bounds)(sim);
+    return NOTIER;
+}
+
+/*
+ * TRUE if the simulation covered the whole schedule: a synchronous task
+ * set starts again at the end of its hyperperiod (if no deadline was
+ * missed) and an asynchronous one once its state repeats
+ */
+int wholeschedule(Sim sim) {
+    if (sim->ts->steady)
+        return sim->repeated;
+    return sim->ts->lcm > 0 && sim->ts->max_time >= sim->ts->lcm;
+}
+
+/*
+ * Admission pipeline of a verdict: the tests are tried from the cheapest
+ * on, and the first one that decides gives it. When the failure instant
+ * is needed (not 'anyfailure'), an overload takes it from the analysis of
+ * the algorithm if that decides, or else the task set is simulated up to
+ * the overload point, whatever its time range (but not beyond the budget,
+ * or the horizon if there is none). After the tests of the
+ * load comes the exact analysis of the algorithm, and the task set is
+ * only simulated if all of them are inconclusive and its time range is
+ * not longer than the budget. Otherwise, or if the simulation finds no
+ * failure in a part of the schedule, it is undecided (sim->failtask is
+ * NULL).
+ * returns the tier that decided
+ */
+int admission(Sim sim, Alg palg, int anyfailure) {
+    int tier;
+    Time t;
+
+    if (!anyfailure && overloaded(sim)) {
+        sim->failtask = NULL;
+        if (palg->analysis != NULL && (palg->analysis)(sim) && sim->failtask != NULL)
+            return UTILIZATION;
+        sim->failtask = NULL;
+        /* without a budget, not further than the horizon */
+        if ((t=overloadpoint(sim, budget? budget : horizon)) == 0)
+            return OVERBUDGET;
+        sim->max_time = t;
+        simulate(sim, palg);
+        return (sim->failtask != NULL)? UTILIZATION : PARTIAL;
+    }
+    if ((tier=loadtier(sim, palg, anyfailure)) != NOTIER)
+        return tier;
+    if (palg->analysis != NULL && (palg->analysis)(sim))
+        return ANALYSIS;
+    sim->failtask = NULL;
+    if (budget && sim->max_time > budget)
+        return OVERBUDGET;
+    simulate(sim, palg);
+    if (sim->failtask == NULL && !wholeschedule(sim))
+        return PARTIAL;
+    return SIMULATION;
+}
+
+/*
+ * simulate the task set under one algorithm and show the results. In
+ * verdict mode the result is just one line, ending with the tier of the
+ * admission pipeline that gave it:
+ *   <file> <algorithm> schedulable <tier>
+ *   <file> <algorithm> unschedulable <time> <task> <tier>
+ *   <file> <algorithm> undecided budget|partial
+ * returns TRUE if a task missed (or was going to miss) its deadline, or
+ * the verdict is undecided
+ */
+int runalgorithm(Sim sim, Alg palg) {
+    FILE *out = sim->out;
+    int tier;
+
+    if( verdict ) {
+        sim->out = NULL;
+        (palg->initialize)(sim);
+        tier = admission(sim, palg, FALSE);
+        (palg->finish)(sim);
+        sim->out = out;
+        if( UNDECIDED(tier) )
+            fprintf(out, "%s %c undecided %s\n", sim->ts->fname, palg->id,
+                    tiername[tier]);
+        else if( sim->failtask == NULL )
+            fprintf(out, "%s %c schedulable %s\n", sim->ts->fname, palg->id,
+                    tiername[tier]);
+        else
+            fprintf(out, "%s %c unschedulable %lld %s %s\n", sim->ts->fname,
+                    palg->id, sim->failtime, sim->failtask->name, tiername[tier]);
+        return UNDECIDED(tier) || sim->failtask != NULL;
+    }
+
+    simprintf(sim, "\nSelected Scheduling Algorithm: %s,\n", palg->label);
+
+    if( verbose ) simprintf(sim, "Initialization\n");
+    (palg->initialize)(sim);
+
+    /* the timeline is simulated anyway, whatever the tier of the verdict */
+    if( verbose ) simprintf(sim, "Analysis\n");
+    tier = loadtier(sim, palg, TRUE);
+    if( palg->analysis && (palg->analysis)(sim) && tier == NOTIER )
+        tier = ANALYSIS;
+    simprintf(sim, "Admission pipeline: decided by the %s test\n\n",
+              tiername[(tier == NOTIER)? SIMULATION : tier]);
+
+    if( verbose ) simprintf(sim, "Simulation\n");
+    simulate(sim, palg);
+
+    if( verbose ) simprintf(sim, "Finishing\n");
+    (palg->finish)(sim);
+
+    if( verbose ) simprintf(sim, "Showing timeline\n");
+    drawtimeline(sim, palg->label);
+    return sim->failtask != NULL;
+}
+
+/*
+ * simulate the task set under all selected algorithms, one after another
+ * returns the number of algorithms under which some task missed a deadline
+ */
+int runtaskset(FILE *out, TaskSet ts) {
+    Alg palg;
+    Sim sim;
+    int failed = 0;
+    int switches[NALGS];
+
+    for(palg=algtable; palg->id; palg++) {
+        switches[palg-algtable] = -1;
+        if( algmask & (1<<(palg-algtable)) ) {    /* if selected */
+            sim = newsim(ts);
+            sim->out = out;
+            failed += runalgorithm(sim, palg);
+            switches[palg-algtable] = sim->context_switches;
+            if( verbose && !verdict ) fprintf(out, "Releasing memory from last algorithm\n");
+            freesim(sim);
+        }
+    }
+    reportswitches(out, switches);
+    return failed;
+}
+
+/*
+ * MLLF is LLF with fewer context switches: if both were simulated, the
+ * switches saved are shown after them. switches[] has those of each
+ * algorithm in algtable (-1 if it was not simulated)
+ */
+void reportswitches(FILE *out, int switches[]) {
+    int l = -1, ml = -1;
+    Alg palg;
+
+    for(palg=algtable; palg->id; palg++) {
+        if( palg->id == 'l' )
+            l = switches[palg-algtable];
+        if( palg->id == 'L' )
+            ml = switches[palg-algtable];
+    }
+    if( verdict || l < 0 || ml < 0 )
         return;
-    if( taskset_title ) {
-        free(taskset_title);
-        taskset_title = NULL;
+    fprintf(out, "\nMLLF: %d context switches against %d under LLF", ml, l);
+    if( l > 0 )
+        fprintf(out, " (%d saved, %.1f%%)", l-ml, 100.0 * (l-ml) / l);
+    fprintf(out, "\n");
+}
+
+/*
+ * Parallel simulation: the selected algorithms are simulated by a pool of
+ * nthreads threads, each simulation on its own context and writing to its
+ * own memory buffer. The buffers are printed afterwards in algtable order.
+ */
+struct job_s {
+    Sim   sim;
+    Alg   palg;
+    char *buffer;
+    size_t size;
+    int   failed;
+    int   switches;             /* context switches of the simulation */
+};
+
+struct pool_s {
+    pthread_mutex_t lock;
+    int next;                   /* first job not taken yet */
+    int njobs;
+    struct job_s *jobs;
+};
+
+void *simworker(void *arg) {
+    struct pool_s *pool = arg;
+    struct job_s *job;
+    int i;
+
+    for(;;) {
+        pthread_mutex_lock(&pool->lock);
+        i = pool->next++;
+        pthread_mutex_unlock(&pool->lock);
+        if( i >= pool->njobs )
+            break;
+        job = pool->jobs+i;
+        job->failed = runalgorithm(job->sim, job->palg);
+        job->switches = job->sim->context_switches;
+        if( verbose && !verdict ) fprintf(job->sim->out, "Releasing memory from last algorithm\n");
+        fclose(job->sim->out);
+        job->sim->out = NULL;
+        freesim(job->sim);
+    }
+    return NULL;
+}
+
+int runparallel(TaskSet ts) {
+    struct pool_s pool;
+    struct job_s jobs[NALGS];
+    pthread_t *threads;
+    Alg palg;
+    int i, n, failed;
+    int switches[NALGS];
+
+    n = 0;
+    for(palg=algtable; palg->id; palg++) {
+        switches[palg-algtable] = -1;
+        if( !(algmask & (1<<(palg-algtable))) )
+            continue;
+        jobs[n].palg = palg;
+        jobs[n].sim = newsim(ts);
+        jobs[n].sim->out = open_memstream(&jobs[n].buffer, &jobs[n].size);
+        if( jobs[n].sim->out == NULL ) {
+            fprintf(stderr, "Not enough memory available\n");
+            exit(-1);
+        }
+        n++;
+    }
+
+    pool.next = 0;
+    pool.njobs = n;
+    pool.jobs = jobs;
+    pthread_mutex_init(&pool.lock, NULL);
+
+    if( n > nthreads )
+        n = nthreads;
+    if( verbose ) printf("Simulating with %d threads\n", n);
+    if( (threads = malloc(n*sizeof(pthread_t))) == NULL ) {
+        fprintf(stderr, "Not enough memory available\n");
+        exit(-1);
+    }
+    for(i=0;i<n;i++) {
+        if( pthread_create(threads+i, NULL, simworker, &pool) != 0 ) {
+            fprintf(stderr, "Can't create simulation thread\n");
+            exit(-1);
+        }
+    }
+    for(i=0;i<n;i++)
+        pthread_join(threads[i], NULL);
+    free(threads);
+    pthread_mutex_destroy(&pool.lock);
+
+    /* output in the same order as the sequential simulation */
+    failed = 0;
+    for(i=0;i<pool.njobs;i++) {
+        fwrite(jobs[i].buffer, 1, jobs[i].size, stdout);
+        free(jobs[i].buffer);
+        failed += jobs[i].failed;
+        switches[jobs[i].palg-algtable] = jobs[i].switches;
+    }
+    reportswitches(stdout, switches);
+    return failed;
+}
+
+/*
+ * Batch mode: the task set files are processed by a work-stealing pool.
+ * Files are loaded BATCHWINDOW*nthreads at a time. The jobs of a window are
+ * submitted longest first (estimated by the simulated time span, the
+ * hyperperiod unless maxtime is given, times the number of tasks), and
+ * while they run the next window is loaded. The output of each file is
+ * collected in memory and printed in input order, so there are never
+ * more than two windows of task sets and outputs in memory.
+ */
+struct batchjob_s {
+    char   *fname;
+    TaskSet ts;
+    double  cost;
+    FILE   *out;
+    char   *buffer;
+    size_t  size;
+    int     done;
+    int     failed;
+};
+
+pthread_mutex_t batchlock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t  batchdone = PTHREAD_COND_INITIALIZER;
+
+void batchworker(void *arg, int worker) {
+    struct batchjob_s *job = arg;
+
+    job->failed = runtaskset(job->out, job->ts);
+    if( !verdict )
+        fprintf(job->out, "\nFinished processig of task set %s\n",job->ts->title);
+    fclose(job->out);
+    cleartaskset(job->ts);
+
+    pthread_mutex_lock(&batchlock);
+    job->done = 1;
+    pthread_cond_broadcast(&batchdone);
+    pthread_mutex_unlock(&batchlock);
+}
+
+/* sort jobs by decreasing cost */
+int batchjobcmp(const void *a, const void *b) {
+    double ca = (*(struct batchjob_s **)a)->cost;
+    double cb = (*(struct batchjob_s **)b)->cost;
+
+    return (ca < cb) - (ca > cb);
+}
+
+/*
+ * print the output of the jobs in order as soon as each one is done
+ * returns the number of failures found
+ */
+int batchflush(struct batchjob_s *jobs, int n) {
+    int i, failed = 0;
+
+    for(i=0;i<n;i++) {
+        pthread_mutex_lock(&batchlock);
+        while( !jobs[i].done )
+            pthread_cond_wait(&batchdone, &batchlock);
+        pthread_mutex_unlock(&batchlock);
+        fwrite(jobs[i].buffer, 1, jobs[i].size, stdout);
+        free(jobs[i].buffer);
+        failed += jobs[i].failed;
     }
+    return failed;
+}
+
+int runbatch(int nfiles, char *files[]) {
+    Workpool pool;
+    struct batchjob_s *jobs[2];     /* the running window and the last one */
+    struct batchjob_s **order;
+    int window, first, n, last, i, w, failed;
+
+    window = BATCHWINDOW*nthreads;
+    if( (jobs[0] = malloc(window*sizeof(struct batchjob_s))) == NULL
+        || (jobs[1] = malloc(window*sizeof(struct batchjob_s))) == NULL
+        || (order = malloc(window*sizeof(struct batchjob_s *))) == NULL ) {
+        fprintf(stderr, "Not enough memory available\n");
+        exit(-1);
+    }
+    if( verbose ) printf("Batch of %d files with %d threads\n", nfiles, nthreads);
+
+    pool = WorkpoolNew(nthreads, batchworker);
+    last = 0;
+    failed = 0;
+    for(first=0, w=0; first<nfiles; first+=n, w^=1) {
+        n = nfiles-first;
+        if( n > window )
+            n = window;
+        for(i=0;i<n;i++) {
+            struct batchjob_s *job = jobs[w]+i;
+
+            job->fname = files[first+i];
+            job->done = 0;
+            job->out = open_memstream(&job->buffer, &job->size);
+            if( job->out == NULL ) {
+                fprintf(stderr, "Not enough memory available\n");
+                exit(-1);
+            }
+            if( verbose && !verdict ) fprintf(job->out, "Loading case info from file %s\n",job->fname);
+            if ((job->ts=readtaskset(verdict? NULL : job->out, job->fname))==NULL) {
+                fprintf(stderr, "Couldn't read case info file %s",job->fname);
+                exit(-1);
+            }
+            if( !verdict )
+                showtaskset(job->out, job->ts);
+            job->cost = (double) job->ts->max_time * job->ts->num_tasks;
+            order[i] = job;
+        }
+        qsort(order, n, sizeof(struct batchjob_s *), batchjobcmp);
+        WorkpoolSubmit(pool, (void **) order, n);
+
+        /* meanwhile, the output of the previous window */
+        failed += batchflush(jobs[w^1], last);
+        last = n;
+    }
+    failed += batchflush(jobs[w^1], last);
+    WorkpoolFree(pool);
+
+    free(order);
+    free(jobs[0]);
+    free(jobs[1]);
+    return failed;
+}
+
+/*
+ * create a task set with n tasks and total utilization u (before rounding
+ * the execution times) with periods drawn from 'periods'
+ */
+TaskSet randomtaskset(int n, double u, int periods[], int nperiods,
+                      unsigned int *seed) {
+    TaskSet ts;
+    Task task;
+    double *v;
+    int *t, i;
+    char name[20];
+
+    if( (ts = malloc(sizeof(struct taskset_s))) == NULL
+        || (ts->tasks = calloc(n+1, sizeof(struct task_struct))) == NULL
+        || (v = malloc(n*sizeof(double))) == NULL
+        || (t = malloc(n*sizeof(int))) == NULL ) {
+        fprintf(stderr, "Not enough memory available\n");
+        exit(-1);
+    }
+    ts->title = strdup("random");
+    ts->fname = "random";
+    ts->num_tasks = n;
+    idletaskinit(ts->tasks+0);
+
+    uunifast(n, u, v, seed);
+    randomperiods(n, periods, nperiods, t, seed);
     for(i=1;i<=n;i++) {
-        free((taskset+i)->name);
+        task = ts->tasks+i;
+        task->sys_id = n-i;
+        sprintf(name, "T%d", n-i+1);
+        task->name = strdup(name);
+        task->state = IDLE;
+        task->criticality = (unirand(seed) < 0.5)? HIGH: LOW;
+        task->period = t[i-1];
+        task->cpu_time = (int) (v[i-1]*t[i-1]+0.5);
+        if( task->cpu_time < 1 )
+            task->cpu_time = 1;
+        if( task->cpu_time > task->period )
+            task->cpu_time = task->period;
+        task->remaining = task->cpu_time;
+        task->reldeadline = task->period;
+    }
+    free(t);
+    free(v);
+    ts->max_time = ts->lcm = hyperperiod(ts);
+    ts->steady = FALSE;
+    ts->constrained = FALSE;
+    ts->omax = 0;
+    ts->capped = FALSE;
+    return ts;
+}
+
+/*
+ * Sweep mode: for each number of tasks and total utilization, 'sets'
+ * random task sets are simulated (silently, with the event-driven engine)
+ * under each selected algorithm, and the fraction of them without
+ * deadline failures is reported as CSV. The points are split into jobs
+ * for the work-stealing pool. Each task set has its own seed, so the
+ * results do not depend on the number of threads.
+ */
+
+struct sweepjob_s {
+    int n;                      /* tasks */
+    int iu;                     /* utilization index */
+    int first, count;           /* task sets */
+    int *periods, nperiods;
+    int schedulable[NALGS];
+    int tiers[NALGS][NTIERS];   /* task sets decided by each tier */
+};
+
+void sweepworker(void *arg, int worker) {
+    struct sweepjob_s *job = arg;
+    unsigned int seed;
+    TaskSet ts;
+    Alg palg;
+    Sim sim;
+    int k, tier;
+
+    for(k=job->first;k<job->first+job->count;k++) {
+        /* a different seed for each task set */
+        seed = sweep.seed*2654435761U ^ job->n*40503U ^ job->iu*2246822519U
+               ^ k*3266489917U;
+        ts = randomtaskset(job->n, sweep.umin+job->iu*sweep.ustep,
+                           job->periods, job->nperiods, &seed);
+        for(palg=algtable; palg->id; palg++) {
+            if( !(algmask & (1<<(palg-algtable))) )
+                continue;
+            sim = newsim(ts);
+            sim->out = NULL;
+            (palg->initialize)(sim);
+            tier = admission(sim, palg, TRUE);
+            (palg->finish)(sim);
+            job->tiers[palg-algtable][tier]++;
+            if( !UNDECIDED(tier) && sim->failtask == NULL )
+                job->schedulable[palg-algtable]++;
+            freesim(sim);
+        }
+        cleartaskset(ts);
     }
-    free(taskset);
+}
 
-    /* release timeline */
-    if( timeline_history ) {
-        free(timeline_history);
-        timeline_history = NULL;
+/* sort jobs by decreasing number of tasks */
+int sweepjobcmp(const void *a, const void *b) {
+    return (*(struct sweepjob_s **)b)->n - (*(struct sweepjob_s **)a)->n;
+}
+
+void runsweep(void) {
+    Workpool pool;
+    struct sweepjob_s *jobs, **order;
+    int periods[SWEEPHYPERPERIOD], nperiods;
+    int nu, npoints, chunk, njobs, n, iu, k, i, total, tier;
+    Alg palg;
+
+    nperiods = divisors(SWEEPHYPERPERIOD, sweep.tmin, sweep.tmax,
+                        periods, SWEEPHYPERPERIOD);
+    if( nperiods == 0 ) {
+        fprintf(stderr, "No period in the range %d to %d\n", sweep.tmin, sweep.tmax);
+        exit(-1);
+    }
+    nu = (int) ((sweep.umax-sweep.umin)/sweep.ustep+1.5e-6) + 1;
+    npoints = ((sweep.nmax-sweep.nmin)/sweep.nstep+1)*nu;
+
+    /* about SWEEPJOBS jobs per thread */
+    chunk = ((long) npoints*sweep.sets + SWEEPJOBS*nthreads-1)/(SWEEPJOBS*nthreads);
+    if( chunk > sweep.sets ) chunk = sweep.sets;
+    if( chunk < 1 ) chunk = 1;
+    njobs = npoints*((sweep.sets+chunk-1)/chunk);
+    if( (jobs = calloc(njobs, sizeof(struct sweepjob_s))) == NULL
+        || (order = malloc(njobs*sizeof(struct sweepjob_s *))) == NULL ) {
+        fprintf(stderr, "Not enough memory available\n");
+        exit(-1);
+    }
+    i = 0;
+    for(n=sweep.nmin; n<=sweep.nmax; n+=sweep.nstep) {
+        for(iu=0; iu<nu; iu++) {
+            for(k=0; k<sweep.sets; k+=chunk) {
+                jobs[i].n = n;
+                jobs[i].iu = iu;
+                jobs[i].first = k;
+                jobs[i].count = (k+chunk <= sweep.sets)? chunk : sweep.sets-k;
+                jobs[i].periods = periods;
+                jobs[i].nperiods = nperiods;
+                order[i] = jobs+i;
+                i++;
+            }
+        }
+    }
+    if( verbose ) fprintf(stderr, "Sweep: %d points, %d jobs, %d threads\n",
+                          npoints, njobs, nthreads);
+
+    qsort(order, njobs, sizeof(struct sweepjob_s *), sweepjobcmp);
+    pool = WorkpoolNew(nthreads, sweepworker);
+    WorkpoolSubmit(pool, (void **) order, njobs);
+    WorkpoolFree(pool);
+
+    /* jobs of the same point are contiguous in 'jobs' */
+    printf("tasks,utilization,sets");
+    for(palg=algtable; palg->id; palg++) {
+        if( algmask & (1<<(palg-algtable)) )
+            printf(",%c", palg->id);
+    }
+    printf("\n");
+    for(i=0; i<njobs; ) {
+        printf("%d,%.4f,%d", jobs[i].n, sweep.umin+jobs[i].iu*sweep.ustep, sweep.sets);
+        for(palg=algtable; palg->id; palg++) {
+            if( !(algmask & (1<<(palg-algtable))) )
+                continue;
+            total = 0;
+            for(k=i; k<njobs && jobs[k].n==jobs[i].n && jobs[k].iu==jobs[i].iu; k++)
+                total += jobs[k].schedulable[palg-algtable];
+            printf(",%.4f", (double) total/sweep.sets);
+        }
+        printf("\n");
+        for(k=i; k<njobs && jobs[k].n==jobs[i].n && jobs[k].iu==jobs[i].iu; k++)
+            ;
+        i = k;
     }
 
+    /* where the time goes: the tier of the admission pipeline of each set */
+    fprintf(stderr, "Task sets decided by each tier:\n");
+    for(palg=algtable; palg->id; palg++) {
+        if( !(algmask & (1<<(palg-algtable))) )
+            continue;
+        fprintf(stderr, "\t%c:", palg->id);
+        for(tier=0; tier<NTIERS; tier++) {
+            total = 0;
+            for(k=0; k<njobs; k++)
+                total += jobs[k].tiers[palg-algtable][tier];
+            fprintf(stderr, " %s %d", tiername[tier], total);
+        }
+        fprintf(stderr, "\n");
+    }
+    free(order);
+    free(jobs);
+}
+
+/* min:max[:step] */
+void parserange(char *value, double *min, double *max, double *step) {
+    char *p;
+
+    *min = *max = strtod(value, &p);
+    if( *p == ':' )
+        *max = strtod(p+1, &p);
+    if( *p == ':' && step )
+        *step = strtod(p+1, &p);
+}
+
+/* sweep specification: key=value[,key=value...] */
+void parsesweep(char *spec) {
+    char *const keys[] = { "tasks", "util", "sets", "seed", "periods", NULL };
+    char *value;
+    double min, max, step;
+
+    while( *spec ) {
+        switch( getsubopt(&spec, keys, &value) ) {
+        case 0: /* tasks */
+            step = 1;
+            parserange(value, &min, &max, &step);
+            sweep.nmin = min; sweep.nmax = max; sweep.nstep = step;
+            break;
+        case 1: /* util */
+            parserange(value, &sweep.umin, &sweep.umax, &sweep.ustep);
+            break;
+        case 2: /* sets */
+            sweep.sets = atoi(value);
+            break;
+        case 3: /* seed */
+            sweep.seed = strtoul(value, NULL, 0);
+            break;
+        case 4: /* periods */
+            parserange(value, &min, &max, NULL);
+            sweep.tmin = min; sweep.tmax = max;
+            break;
+        default:
+            fprintf(stderr, "Invalid sweep specification %s\n", value? value: spec);
+            exit(-1);
+        }
+        if( value == NULL ) {
+            fprintf(stderr, "Missing value in sweep specification\n");
+            exit(-1);
+        }
+    }
+    if( sweep.nmin < 1 || sweep.nmin > sweep.nmax
+        || sweep.nstep < 1 || sweep.ustep <= 0.0 || sweep.umin <= 0.0
+        || sweep.umin > sweep.umax || sweep.sets < 1 ) {
+        fprintf(stderr, "Invalid sweep specification\n");
+        exit(-1);
+    }
 }
+
 /*
  * interpret command line and initialize data structures
  */
@@ -984,11 +2937,54 @@ int mask;
 struct alg_s *p;
 
     algmask = 0;
-    while( (ch=getopt(argc,argv,"velmraw:")) != -1 ) {
+    while( (ch=getopt(argc,argv,"velLmrabdj:k:p:qs:t:w:")) != -1 ) {
         switch (ch){
             case 'a': /* alternate timeline output */
                 timelineformat = 2;
                 break;
+            case 'b': /* batch mode */
+                batch = 1;
+                break;
+            case 'd': /* event-driven simulation */
+                eventdriven = 1;
+                break;
+            case 'j': /* parallel simulation */
+                nthreads = atoi(optarg);
+                if( nthreads <= 0 )
+                    nthreads = sysconf(_SC_NPROCESSORS_ONLN);
+                if( nthreads <= 0 )
+                    nthreads = 1;
+                break;
+            case 'p': /* simulation budget */
+                budget = atoll(optarg);
+                if( budget < 0 ) {
+                    fprintf(stderr,"Invalid budget\n");
+                    usage();
+                    exit(-1);
+                }
+                break;
+            case 'q': /* verdict only */
+                verdict = 1;
+                break;
+            case 's': /* sweep mode */
+                sweepmode = 1;
+                parsesweep(optarg);
+                break;
+            case 'k': /* task list implementation */
+                if( (queuekind = PQueueKind(optarg)) < 0 ) {
+                    fprintf(stderr,"Unknown task list implementation: %s\n", optarg);
+                    usage();
+                    exit(-1);
+                }
+                break;
+            case 't': /* largest hyperperiod */
+                horizon = atoll(optarg);
+                if( horizon < 0 ) {
+                    fprintf(stderr,"Invalid horizon\n");
+                    usage();
+                    exit(-1);
+                }
+                break;
             case 'w':
                 screenwidth = atoi(optarg);
                 break;
@@ -1029,73 +3025,63 @@ struct alg_s *p;
  */
 
 int main(int argc, char *argv[]) {
-Alg palg = algtable;
-int alg;
 int iarg;
+TaskSet ts = NULL;
+int failed = 0;
 
     SkiplInit();
 
     init(argc, argv);
 
+    if( batch || sweepmode ) {
+        if( nthreads == 1 )
+            nthreads = sysconf(_SC_NPROCESSORS_ONLN);
+        if( nthreads <= 0 )
+            nthreads = 1;
+    }
+    if( sweepmode ) {
+        eventdriven = 1;
+        verdict = 1;
+        runsweep();
+        return 0;
+    }
+    if( batch ) {
+        failed = runbatch(argc-optind, argv+optind);
+        return (verdict && failed)? 1 : 0;
+    }
+
     for(iarg=optind;iarg<argc;iarg++) {
 
         /* release previous allocated memory */
 
-        if( taskset ) {
-            if( verbose ) printf("Releasing memory from last case info\n");
-            cleartaskset(taskset,num_tasks);
-            taskset = NULL;
+        if( ts ) {
+            if( verbose && !verdict ) printf("Releasing memory from last case info\n");
+            cleartaskset(ts);
+            ts = NULL;
         }
 
-        if( verbose ) printf("Loading case info from file %s\n",argv[iarg]);
+        if( verbose && !verdict ) printf("Loading case info from file %s\n",argv[iarg]);
 
-        if (readtaskset(argv[iarg])==FALSE) {
+        if ((ts=readtaskset(verdict? NULL : stdout, argv[iarg]))==NULL) {
             fprintf(stderr, "Couldn't read case info file %s",argv[iarg]);
             exit(-1);
         }
-        showtaskset();
-
-        if( verbose ) printf("Algorithms to be analyzed%X\n",algmask);
-
-        palg = algtable;
-        while(palg->id) {
-
-            alg = palg-algtable;
-
-            if( algmask & (1<<alg) ) {    /* if selected */
+        if( !verdict )
+            showtaskset(stdout, ts);
 
-                printf("\nSelected Scheduling Algorithm: %s,\n", palg->label);
+        if( verbose && !verdict ) printf("Algorithms to be analyzed%X\n",algmask);
 
-                /* init system lists */
-                merit_list = NewList();
-                request_list = NewList();
-
-                if( verbose ) printf("Initialization\n");
-                (palg->initialize)();
-
-                if( verbose ) printf("Simulation\n");
-                simulate(palg);
-
-                if( verbose ) printf("Finishing\n");
-                (palg->finish)();
-
-                if( verbose ) printf("Showing timeline\n");
-                drawtimeline(palg->label);
-
-                if( verbose ) printf("Releasing memory from last algorithm\n");
-                FreeList(merit_list); merit_list = NULL;
-                FreeList(request_list); request_list = NULL;
-
-            }
-            palg++;
-            }
-        printf("\nFinished processig of task set %s\n",taskset_title);
+        if( nthreads > 1 )
+            failed += runparallel(ts);
+        else
+            failed += runtaskset(stdout, ts);
+        if( !verdict )
+            printf("\nFinished processig of task set %s\n",ts->title);
     }
 #ifdef DMALLOC
-    free(taskset);
-    free(timeline_history);
+    cleartaskset(ts);
     dmalloc_shutdown();
 #endif
-    return 0;
+    return (verdict && failed)? 1 : 0;
 }
 
@@ -0,0 +1,7 @@
+title Tasks with the same laxity
+maxtime 39
+tasks 3
+task A  HIGH  20  6
+task B  HIGH  20  6
+task C  LOW   20  6
+end
@@ -56,6 +56,28 @@
  *              structures to avoid collision
  *           4) Initialization is automatic (by first call to SkiplNew)
  *
+ *      Changes made Hans - 2026:
+ *           1) NIL is a statically initialized node that is never written,
+ *              so lists can be used by many threads without SkiplInit
+ *           2) rand() replaced by a xorshift generator whose state is kept
+ *              in the SkipList structure (SkiplSeed sets it)
+ *           3) Keys are a (key,tie) pair compared by SKIPL_LESS and
+ *              SKIPL_EQUAL, instead of a key and a tie breaker packed in
+ *              one integer
+ *           4) Nodes come from a pool of each list: deleted nodes are kept
+ *              in free lists by level and new ones are carved from big
+ *              chunks, so malloc is called once per chunk and SkiplFree
+ *              just releases the chunks
+ *           5) Nodes have backward pointers too, so a node is deleted
+ *              without searching for it (SkiplDeleteNode, SkiplPopMin).
+ *              SkiplInsertNode returns the node inserted
+ *           6) SkiplInsertSorted inserts a sorted array of entries in one
+ *              pass (and builds a list in linear time if it was empty)
+ *           7) SkiplDeleteUpTo deletes all the nodes up to a key at once,
+ *              passing each one to a callback
+ *           8) A benchmark driver (SKIPL_BENCH) measures each operation for
+ *              lists of 16 to 10^7 entries, with CSV output
+ *
  ***************************************************************************/
 #define SKIPL_SOURCE
 /* #define DEBUG */
@@ -67,6 +89,13 @@
 #include <stdio.h>  /* for stderr */
 #include <stdlib.h> /* for rand() and malloc() */
 
+#if defined (SKIPL_BENCH)
+  #include <stdint.h>       /* for intptr_t */
+  #include <string.h>       /* for strcmp() */
+  #include <time.h>         /* for clock_gettime() */
+  #include <sys/resource.h> /* for getrusage() */
+#endif
+
 #if defined (SKIPL_TEST)
   #include <string.h> /* for memset */
   #if defined (MSC)
@@ -81,13 +110,37 @@
 #include "skipl.h"
 
 
+/* number of bits of value returned by nextRandom */
+#define BitsInRandom     31
+/* initial state of the random generator of each list */
+#define DefaultSeed      2463534242U
+
+/* #define allowDuplicates */ /* NO DUPLICATES allowed */
+
+#define false 0
+#define true 1
+
+#define MaxNumberOfLevels 16
+#define MaxLevel (MaxNumberOfLevels-1)
+
+/* size of the blocks of memory of the node pool */
+#define ChunkSize        16384
+
+/* key and v first: pqueue.c reads a node as a struct PQueueEntryStructure */
 struct SkiplNodeStructure{
     SkiplKeyType key;
     SkiplValueType v;
-    #ifdef SKIPL_TEST
     int level;
-    #endif
-    SkiplNode forward[1]; /* variable sized array of forward pointers */
+    SkiplNode forward[1]; /* variable sized array of forward pointers,
+                           * followed by as many backward pointers */
+};
+
+/* the node before n in level k */
+#define Backward(N,K) ((N)->forward[(N)->level+1+(K)])
+
+/* storage for nodes, allocated ChunkSize bytes at a time */
+struct SkiplChunkStructure {
+    struct SkiplChunkStructure *next;
 };
 
 struct SkipListStructure {
@@ -95,82 +148,113 @@ struct SkipListStructure {
              * (1 more than the number of levels in the SkipList) */
     int randomsLeft;
     int randomBits;
+    unsigned int seed; /* state of the random generator of this list */
 
     struct SkiplNodeStructure * header; /* pointer to header */
-};
-
-static SkiplNode NIL;
-
-/* random function used */
-#define random rand
-/* number of bits of value returned by random */
-#define BitsInRandom     31
-
-/* #define allowDuplicates */ /* NO DUPLICATES allowed */
-
-#define false 0
-#define true 1
 
-#define MaxNumberOfLevels 16
-#define MaxLevel (MaxNumberOfLevels-1)
+    /* node pool */
+    struct SkiplChunkStructure *chunks; /* all chunks allocated */
+    char *chunkFree;                    /* unused part of the last chunk */
+    size_t chunkLeft;
+    SkiplNode freeNodes[MaxNumberOfLevels+1]; /* deleted nodes by level,
+                                               * linked by forward[0] */
+};
 
 
 /* private functions' prototypes */
-static SkiplNode newNodeOfLevel(int level);
+static SkiplNode newNodeOfLevel(SkipList l, int level);
+static int insertNode(SkipList l, SkiplKeyType key, SkiplValueType value,
+    SkiplNode *nodePointer);
+static SkiplNode linkNode(SkipList l, SkiplNode update[], SkiplKeyType key,
+    SkiplValueType value);
+static void unlinkNode(SkipList l, SkiplNode q);
+static int nextRandom(SkipList l);
 static int randomLevel(SkipList l);
 #ifdef SKIPL_TEST
 static void show_skipl(SkipList l);
+static void count_node(SkiplKeyType key, SkiplValueType value, void *arg);
 #ifdef MSC
 static void heapstat(int status);
 #endif    /* MSC */
 #endif    /* SKIPL_TEST */
 
-#ifdef DEBUG
-static void free_list(SkipList l){
-    l->header=NULL;
-    free(l);
-}
-
-static void free_node(SkiplNode q){
-    q->key=0;
+/* a node of 'level' goes back to the pool of its list */
+static void free_node(SkipList l, SkiplNode q, int level){
+    #ifdef DEBUG
     #ifdef SKIPL_TEST
+    q->key=0;
     q->v=0;
     #else
     q->v=NULL;
     #endif    /* SKIPL_TEST */
-    free(q);
+    #endif    /* DEBUG */
+    q->forward[0] = l->freeNodes[level];
+    l->freeNodes[level] = q;
 }
 
-#else     /* DEBUG */
-#define free_list(l) free(l)
-#define free_node(q) free(q)
-#endif    /* DEBUG */
+static void free_list(SkipList l){
+    struct SkiplChunkStructure *c;
+
+    while( (c=l->chunks) != NULL ) {
+        l->chunks = c->next;
+        free(c);
+    }
+    #ifdef DEBUG
+    l->header=NULL;
+    #endif
+    free(l);
+}
 
 
-static SkiplNode NIL; /* NIL is unique among all lists created */
-static int initialized = 0;
+/*
+ * NIL is unique among all lists created. It is only read after its
+ * static initialization, so it can be shared by lists used by
+ * different threads
+ */
+static struct SkiplNodeStructure NILNode = {
+    .key = SKIPL_MAXKEY,   /* greater than any key */
+    .forward = { &NILNode }
+};
+#define NIL (&NILNode)
 
+/* nothing left to initialize: kept for compatibility */
 void SkiplInit(void)
 {
-    NIL = newNodeOfLevel(0);
-    NIL->key = SKIPL_MAXKEY;
-    NIL->forward[0]=NIL;
-    initialized = 1;
 }
 
-static SkiplNode newNodeOfLevel(int level)
+/* nodes are aligned as the node structure in the chunks */
+#define NodeAlign       sizeof(long long)
+#define NodeSize(level) \
+    ((sizeof(struct SkiplNodeStructure) + (2*(level)+1)*sizeof(SkiplNode) \
+        + NodeAlign-1) & ~(NodeAlign-1))
+#define ChunkHeaderSize \
+    ((sizeof(struct SkiplChunkStructure) + NodeAlign-1) & ~(NodeAlign-1))
+
+static SkiplNode newNodeOfLevel(SkipList l, int level)
 {
     SkiplNode n;
+    struct SkiplChunkStructure *c;
+    size_t size = NodeSize(level);
 
-    if((n=malloc(sizeof(struct SkiplNodeStructure) + level*sizeof(SkiplNode ) ))==NULL){
-        fprintf(stderr, "Insufficient memory available");
-        exit(-1);
-    }else{
-        #ifdef SKIPL_TEST
-        n->level=level;
-        #endif
-        return(n);
+    if((n=l->freeNodes[level]) != NULL) {
+        l->freeNodes[level] = n->forward[0];
+    } else {
+        if(l->chunkLeft < size) {
+            if((c=malloc(ChunkSize))==NULL){
+                fprintf(stderr, "Insufficient memory available");
+                exit(-1);
+            }
+            c->next = l->chunks;
+            l->chunks = c;
+            l->chunkFree = (char *) c + ChunkHeaderSize;
+            l->chunkLeft = ChunkSize - ChunkHeaderSize;
+        }
+        n = (SkiplNode) l->chunkFree;
+        l->chunkFree += size;
+        l->chunkLeft -= size;
     }
+    n->level=level;
+    return(n);
 }
 
 
@@ -179,33 +263,49 @@ SkipList SkiplNew(void)
     SkipList l;
     int i;
 
-    if(!initialized ) SkiplInit();
     if((l = (SkipList)malloc(sizeof(struct SkipListStructure)) )==NULL) {
         return NULL;
     }
     l->level = 0;
-    l->header = newNodeOfLevel(MaxNumberOfLevels);
-    l->randomBits = random();
-    l->randomsLeft = BitsInRandom/2;
+    l->chunks = NULL;
+    l->chunkFree = NULL;
+    l->chunkLeft = 0;
+    for(i=0; i<=MaxNumberOfLevels; i++)
+        l->freeNodes[i] = NULL;
+    l->header = newNodeOfLevel(l, MaxNumberOfLevels);
+    SkiplSeed(l, DefaultSeed);
     for(i=0; i<MaxNumberOfLevels; i++)
         l->header->forward[i] = NIL;
     return(l);
 }
 
 
+/* all nodes are in the chunks of the list */
 void SkiplFree(SkipList l)
 {
-    SkiplNode p,q;
-    p = l->header;
-    do{
-        q = p->forward[0];
-        free_node(p);
-        p = q;
-    }while (p!=NIL);
     free_list(l);
 }
 
 
+void SkiplSeed(SkipList l, unsigned int seed)
+{
+    l->seed = seed ? seed : DefaultSeed; /* xorshift state can't be 0 */
+    l->randomBits = nextRandom(l);
+    l->randomsLeft = BitsInRandom/2;
+}
+
+/* xorshift32 (Marsaglia): each list has its own, no shared state */
+static int nextRandom(SkipList l)
+{
+    unsigned int x = l->seed;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    l->seed = x;
+    return (int) (x & 0x7FFFFFFF);
+}
+
 static int randomLevel(SkipList l)
 {
     int level = 0;
@@ -217,7 +317,7 @@ static int randomLevel(SkipList l)
         if (!b) level++;
         l->randomBits >>= 2;     /* >>= 1 for p=0.5 */
         if (-- (l->randomsLeft) == 0) {
-            l->randomBits = random();
+            l->randomBits = nextRandom(l);
             l->randomsLeft = BitsInRandom/2;
         };
     } while (!b);
@@ -227,7 +327,12 @@ static int randomLevel(SkipList l)
 
 
 
-int SkiplInsert(SkipList l, SkiplKeyType key, SkiplValueType value)
+/*
+ * the node with the key is stored in *nodePointer. Returns false if it
+ * was already there (and its value is replaced)
+ */
+static int insertNode(SkipList l, SkiplKeyType key, SkiplValueType value,
+    SkiplNode *nodePointer)
 {
     int k;
     SkiplNode update[MaxNumberOfLevels];
@@ -236,69 +341,215 @@ int SkiplInsert(SkipList l, SkiplKeyType key, SkiplValueType value)
     p = l->header;
     k = l->level;
     do{
-        while (q = p->forward[k], q->key < key)
+        while (q = p->forward[k], SKIPL_LESS(q->key, key))
             p = q;
         update[k] = p;
     } while(--k>=0);
 
 #ifndef allowDuplicates
-    if (q->key == key) {
+    if (SKIPL_EQUAL(q->key, key)) {
         q->v = value;
+        *nodePointer = q;
         return(false);
     }
 #endif
 
+    *nodePointer = linkNode(l, update, key, value);
+#ifndef allowDuplicates
+    return(true);
+#endif
+}
+
+
+/* a new node goes after update[k] in each of its levels k */
+static SkiplNode linkNode(SkipList l, SkiplNode update[], SkiplKeyType key,
+    SkiplValueType value)
+{
+    int k;
+    SkiplNode p,q;
+
     k = randomLevel(l);
     if(k> l->level){
         k = ++ (l->level);
         update[k] = l->header;
     }
 
-    q = newNodeOfLevel(k);
+    q = newNodeOfLevel(l, k);
     q->key = key;
     q->v = value;
     do{
         p = update[k];
         q->forward[k] = p->forward[k];
         p->forward[k] = q;
+        Backward(q,k) = p;
+        if (q->forward[k] != NIL)       /* NIL is never written */
+            Backward(q->forward[k],k) = q;
     }while(--k>=0);
 
-#ifndef allowDuplicates
-    return(true);
-#endif
+    return(q);
+}
+
+
+int SkiplInsert(SkipList l, SkiplKeyType key, SkiplValueType value)
+{
+    SkiplNode q;
+
+    return insertNode(l, key, value, &q);
+}
+
+
+SkiplNode SkiplInsertNode(SkipList l, SkiplKeyType key, SkiplValueType value)
+{
+    SkiplNode q;
+
+    insertNode(l, key, value, &q);
+    return q;
+}
+
+
+/*
+ * the entries are in increasing key order, so the search of each one goes
+ * on from where the previous one stopped, and the whole batch is inserted
+ * in one pass over the list
+ */
+int SkiplInsertSorted(SkipList l, SkiplEntryType e[], int n, SkiplNode nodes[])
+{
+    int i, k, inserted = 0;
+    SkiplNode update[MaxNumberOfLevels];
+    SkiplNode p,q;
+
+    for(k=0; k<MaxNumberOfLevels; k++)
+        update[k] = l->header;
+    for(i=0; i<n; i++) {
+        k = l->level;
+        do{
+            p = update[k];
+            while (q = p->forward[k], SKIPL_LESS(q->key, e[i].key))
+                p = q;
+            update[k] = p;
+        } while(--k>=0);
+
+        if (SKIPL_EQUAL(q->key, e[i].key)) {
+            q->v = e[i].value;
+        } else {
+            q = linkNode(l, update, e[i].key, e[i].value);
+            inserted++;
+        }
+        /* the next keys are greater: q is before them in its levels */
+        for(k=0; k<=q->level; k++)
+            update[k] = q;
+        if (nodes != NULL)
+            nodes[i] = q;
+    }
+    return(inserted);
+}
+
+
+/* the neighbours of q are linked to each other: no search is needed */
+static void unlinkNode(SkipList l, SkiplNode q)
+{
+    int k, m;
+    SkiplNode p, s;
+
+    for(k=0; k<=q->level; k++) {
+        p = Backward(q,k);
+        s = p->forward[k] = q->forward[k];
+        if (s != NIL)
+            Backward(s,k) = p;
+    }
+    free_node(l, q, q->level);
+    m = l->level;
+    while(l->header->forward[m] == NIL && m > 0 )
+             m--;
+    l->level = m;
 }
 
 
 int SkiplDelete(SkipList l, SkiplKeyType key)
 {
-    int k,m;
-    SkiplNode update[ MaxNumberOfLevels];
+    int k;
     SkiplNode p, q;
 
     p = l->header;
-    k = m = l->level;
+    k = l->level;
     do {
         /* if the node ahead of p has lower key, advance p */
-        while (q = p->forward[k], q->key < key) p = q;
-        update[k] = p;
+        while (q = p->forward[k], SKIPL_LESS(q->key, key)) p = q;
     } while(--k>=0);
 
-    if(q->key == key) {
-        for(k=0; k<=m && (p=update[k])->forward[k] == q; k++)
-            p->forward[k] = q->forward[k];
-        free_node(q);
-        while(l->header->forward[m] == NIL && m > 0 )
-                 m--;
-
-        l->level = m;
+    if(SKIPL_EQUAL(q->key, key)) {
+        unlinkNode(l, q);
         return(true);
-
     } else {
         return(false);
     }
 }
 
 
+void SkiplDeleteNode(SkipList l, SkiplNode n)
+{
+    unlinkNode(l, n);
+}
+
+
+/*
+ * the nodes up to the key are the first ones of the list: the last of them
+ * in each level is found in one descent, the header is linked to the nodes
+ * after them and they are visited (and freed) walking level 0
+ */
+int SkiplDeleteUpTo(SkipList l, SkiplKeyType key, SkiplCallback callback, void *arg)
+{
+    int k, m, n;
+    SkiplNode update[MaxNumberOfLevels];
+    SkiplNode p, q, s;
+
+    p = l->header;
+    k = m = l->level;
+    do {
+        while (q = p->forward[k], !SKIPL_LESS(key, q->key) && q != NIL)
+            p = q;
+        update[k] = p;
+    } while(--k>=0);
+    if (update[0] == l->header)
+        return(0);
+
+    q = l->header->forward[0];
+    s = update[0]->forward[0];          /* first node left */
+    for(k=0; k<=m; k++) {
+        if (update[k] == l->header)
+            break;
+        l->header->forward[k] = update[k]->forward[k];
+        if (l->header->forward[k] != NIL)
+            Backward(l->header->forward[k],k) = l->header;
+    }
+    for(n=0; q != s; n++) {
+        p = q->forward[0];
+        if (callback != NULL)
+            (*callback)(q->key, q->v, arg);
+        free_node(l, q, q->level);
+        q = p;
+    }
+    while(l->header->forward[m] == NIL && m > 0 )
+             m--;
+    l->level = m;
+    return(n);
+}
+
+
+/* the first node is in the first levels of the header */
+int SkiplPopMin(SkipList l, SkiplKeyType *keyPointer, SkiplValueType *valuePointer)
+{
+    SkiplNode q = l->header->forward[0];
+
+    if (q == NIL)
+        return(false);
+    *keyPointer = q->key;
+    *valuePointer = q->v;
+    unlinkNode(l, q);
+    return(true);
+}
+
+
 int SkiplSearch(SkipList l, SkiplKeyType key, SkiplValueType *valuePointer)
 {
     int k;
@@ -307,12 +558,12 @@ int SkiplSearch(SkipList l, SkiplKeyType key, SkiplValueType *valuePointer)
     p = l->header;
     k = l->level;
     do {
-        while (q = p->forward[k], q->key < key) {
+        while (q = p->forward[k], SKIPL_LESS(q->key, key)) {
             p = q;
         }
     } while (--k>=0);
 
-    if (q->key != key) {
+    if (!SKIPL_EQUAL(q->key, key)) {
         return(false);
     } else {
         *valuePointer = q->v;
@@ -350,9 +601,188 @@ SkiplKeyType SkiplGetKey(SkiplNode n) {
 }
 
 
+#ifdef SKIPL_BENCH
+/*
+ * Benchmark of lists of 16 to 'maxsize' entries (10^7 by default, or the
+ * argument) with three patterns of keys:
+ *      uniform     random keys
+ *      increasing  keys inserted in increasing order
+ *      periodic    release times of tasks with random periods from 10 to
+ *                  1000: 'reinsert' pops the first one and inserts it again
+ *                  one period later, as the scheduler does
+ * Each size is built, emptied by deleting its keys in random order, built
+ * again and emptied by popping, as many times as needed for BenchOps
+ * operations. The output is CSV, one record per line:
+ *      time,<pattern>,<size>,<operation>,<ns per operation>
+ *      level,<pattern>,<size>,<level>,<nodes of that level>
+ *      rss,<pattern>,<size>,peak_kb,<peak resident set size so far>
+ */
+#define BenchOps        1000000 /* operations measured at least */
+
+static const char *benchPatterns[] = { "uniform", "increasing", "periodic" };
+
+static unsigned long long benchSeed = 88172645463325252ULL;
+static SkiplKeyType *benchKeys;     /* in insertion order */
+static SkiplKeyType *benchOrder;    /* the same, shuffled */
+static long long *benchPeriods;     /* of each tie */
+static volatile long benchSink;     /* so that nothing is optimized out */
+
+/* xorshift64 */
+static unsigned long long benchRandom(void)
+{
+    benchSeed ^= benchSeed << 13;
+    benchSeed ^= benchSeed >> 7;
+    benchSeed ^= benchSeed << 17;
+    return benchSeed;
+}
+
+static double benchNow(void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec*1e9 + t.tv_nsec;
+}
+
+static void benchMakeKeys(const char *pattern, int n)
+{
+    SkiplKeyType t;
+    int i, j;
+
+    for(i=0; i<n; i++) {
+        benchKeys[i].tie = i;
+        if( strcmp(pattern, "uniform") == 0 ) {
+            benchKeys[i].key = benchRandom() % (1LL<<40);
+        } else if( strcmp(pattern, "increasing") == 0 ) {
+            benchKeys[i].key = i;
+        } else {
+            benchPeriods[i] = 10 + benchRandom()%991;
+            benchKeys[i].key = benchRandom()%benchPeriods[i];
+        }
+        benchOrder[i] = benchKeys[i];
+    }
+    for(i=n-1; i>0; i--) {
+        j = benchRandom()%(i+1);
+        t = benchOrder[i];
+        benchOrder[i] = benchOrder[j];
+        benchOrder[j] = t;
+    }
+}
+
+static void benchBuild(SkipList l, int n)
+{
+    int i;
+
+    for(i=0; i<n; i++)
+        SkiplInsert(l, benchKeys[i], (SkiplValueType) (intptr_t) i);
+}
+
+static void benchReport(const char *pattern, int n, const char *op, double ns, long ops)
+{
+    printf("time,%s,%d,%s,%.2f\n", pattern, n, op, ns/ops);
+}
+
+static void benchSize(const char *pattern, int n)
+{
+    SkipList l;
+    SkiplNode p;
+    SkiplKeyType key;
+    SkiplValueType v;
+    struct rusage usage;
+    double t, tinsert = 0, tdelete = 0, tpop = 0;
+    long i, count[MaxNumberOfLevels+1];
+    int r, reps = (n < BenchOps)? BenchOps/n : 1;
+
+    benchMakeKeys(pattern, n);
+    l = SkiplNew();
+    for(r=0; r<reps; r++) {
+        t = benchNow();
+        benchBuild(l, n);
+        tinsert += benchNow()-t;
+        t = benchNow();
+        for(i=0; i<n; i++)
+            SkiplDelete(l, benchOrder[i]);
+        tdelete += benchNow()-t;
+        benchBuild(l, n);
+        t = benchNow();
+        while( SkiplPopMin(l, &key, &v) )
+            ;
+        tpop += benchNow()-t;
+    }
+    benchReport(pattern, n, "insert", tinsert, (long) n*reps);
+    benchReport(pattern, n, "delete", tdelete, (long) n*reps);
+    benchReport(pattern, n, "popmin", tpop, (long) n*reps);
+
+    benchBuild(l, n);
+    t = benchNow();
+    for(i=0; i<BenchOps; i++)
+        benchSink += SkiplSearch(l, benchOrder[i%n], &v);
+    benchReport(pattern, n, "search", benchNow()-t, BenchOps);
+    t = benchNow();
+    for(i=0; i<BenchOps; i++)
+        benchSink += (SkiplHead(l) != NULL);
+    benchReport(pattern, n, "head", benchNow()-t, BenchOps);
+    t = benchNow();
+    for(i=0; i<(long) n*reps; )
+        for(p=SkiplHead(l); p!=NULL; p=SkiplNext(p))
+            i++;
+    benchReport(pattern, n, "iterate", benchNow()-t, i);
+
+    for(i=0; i<=MaxNumberOfLevels; i++)
+        count[i] = 0;
+    for(p=l->header->forward[0]; p!=NIL; p=p->forward[0])
+        count[p->level]++;
+    if( strcmp(pattern, "periodic") == 0 ) {
+        t = benchNow();
+        for(i=0; i<BenchOps; i++) {
+            SkiplPopMin(l, &key, &v);
+            key.key += benchPeriods[key.tie];
+            SkiplInsert(l, key, v);
+        }
+        benchReport(pattern, n, "reinsert", benchNow()-t, BenchOps);
+    }
+    SkiplFree(l);
+
+    for(i=0; i<MaxNumberOfLevels && count[i]; i++)
+        printf("level,%s,%d,%ld,%ld\n", pattern, n, i, count[i]);
+    getrusage(RUSAGE_SELF, &usage);
+    printf("rss,%s,%d,peak_kb,%ld\n", pattern, n, usage.ru_maxrss);
+    fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+    int maxsize = 10000000;
+    int p, n;
+
+    if( argc > 1 && (maxsize=atoi(argv[1])) < 16 ) {
+        fprintf(stderr, "Usage: %s [maxsize]\n", argv[0]);
+        return 1;
+    }
+    if( (benchKeys=malloc(maxsize*sizeof(SkiplKeyType))) == NULL
+        || (benchOrder=malloc(maxsize*sizeof(SkiplKeyType))) == NULL
+        || (benchPeriods=malloc(maxsize*sizeof(long long))) == NULL ) {
+        fprintf(stderr, "Insufficient memory available");
+        exit(-1);
+    }
+    printf("record,pattern,size,name,value\n");
+    for(p=0; p<sizeof(benchPatterns)/sizeof(benchPatterns[0]); p++) {
+        benchSize(benchPatterns[p], 16);
+        for(n=100; n<=maxsize; n*=10)
+            benchSize(benchPatterns[p], n);
+    }
+    free(benchKeys);
+    free(benchOrder);
+    free(benchPeriods);
+    return 0;
+}
+#endif /* SKIPL_BENCH */
+
 #ifdef SKIPL_TEST
 #define sampleSize 1000
 SkiplKeyType keys[sampleSize];
+SkiplNode nodes[sampleSize];
+SkiplEntryType entries[sampleSize];
 
 static void show_skipl(SkipList l)
 {
@@ -380,6 +810,17 @@ static void show_skipl(SkipList l)
     printf("NIL\n\n");
 }
 
+/* counts the nodes deleted (and checks their order) */
+static void count_node(SkiplKeyType key, SkiplValueType value, void *arg)
+{
+    static int last = -1;
+
+    if (key <= last || value != key)
+        printf("error in delete up to a key #%d\n", key);
+    last = key;
+    (*(int *) arg)++;
+}
+
 int main(void) {
     SkipList l;
     int i,k;
@@ -394,11 +835,10 @@ int main(void) {
 
     printf("Building enter #\n");
     for(k=0; k<sampleSize; k++){
-        keys[ k]=random();
+        keys[ k]=rand();
         SkiplInsert(l, keys[k], keys[k]);
-        printf("\r% 3d", k);
     }
-    printf("\n\n");
+    printf("\n");
 
     show_skipl(l);
     puts("Computing tests...");
@@ -419,12 +859,52 @@ int main(void) {
             if(!SkiplDelete(l, keys[k]))
                 printf("error in delete\n");
             else{
-                keys[k] = random();
+                keys[k] = rand();
                 SkiplInsert(l,keys[k],keys[k]);
             }
         }
     }
 
+    puts("Popping in order...");
+    for(i=0; SkiplPopMin(l, &k, &v); i=k)
+        if (k < i || v != k)
+            printf("error in pop\n");
+    if (!SkiplIsEmpty(l))
+        printf("list not empty after popping\n");
+
+    puts("Inserting sorted...");
+    for(k=0; k<sampleSize; k++) {
+        entries[k].key = 2*k;
+        entries[k].value = 2*k;
+    }
+    SkiplInsertSorted(l, entries, sampleSize/2, nodes);   /* empty list */
+    for(k=0; k<sampleSize; k++)
+        entries[k].key = entries[k].value = k;
+    if (SkiplInsertSorted(l, entries, sampleSize, nodes) != sampleSize/2)
+        printf("error in sorted insert\n");
+    for(i=-1, k=0; SkiplPopMin(l, &k, &v); i=k)
+        if (k != i+1 || v != k)
+            printf("error in sorted insert #%d\n", k);
+
+    puts("Deleting up to a key...");
+    for(k=0; k<sampleSize; k++)
+        SkiplInsert(l, k, k);
+    i = 0;
+    if (SkiplDeleteUpTo(l, -1, count_node, &i) != 0
+        || SkiplDeleteUpTo(l, sampleSize/2, count_node, &i) != sampleSize/2+1
+        || SkiplDeleteUpTo(l, 2*sampleSize, count_node, &i) != sampleSize/2-1
+        || !SkiplIsEmpty(l) || i != sampleSize)
+        printf("error in delete up to a key\n");
+
+    puts("Deleting by node...");
+    for(k=0; k<sampleSize; k++)
+        nodes[k] = SkiplInsertNode(l, k, k);
+    for(k=0; k<sampleSize; k+=2)
+        SkiplDeleteNode(l, nodes[k]);
+    for(k=0; k<sampleSize; k++)
+        if (SkiplSearch(l, k, &v) != (k%2))
+            printf("error in delete by node #%d\n", k);
+
     #ifdef MSC
     heapstat(_heapchk());
     #endif
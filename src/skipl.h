@@ -6,25 +6,48 @@
 #define SKIPL_H
 
 #ifndef SKIPL_TEST   /* when the library is used in a project... */
-  #include<values.h> /* for MAXLONG */
-  typedef long SkiplKeyType;
-  #define SKIPL_MAXKEY    MAXLONG
+  #include <limits.h> /* for LLONG_MAX */
+  /* keys are ordered by 'key' and equal ones by 'tie' */
+  typedef struct {
+      long long key;
+      int       tie;
+  } SkiplKeyType;
+  #define SKIPL_MAXKEY    { LLONG_MAX, INT_MAX }
+  #define SKIPL_LESS(A,B) ((A).key < (B).key || ((A).key == (B).key && (A).tie < (B).tie))
+  #define SKIPL_EQUAL(A,B) ((A).key == (B).key && (A).tie == (B).tie)
   typedef void *SkiplValueType;
 #else   /* for testing */
   #include <values.h> /* for MAXINT */
   typedef int SkiplKeyType;
   #define SKIPL_MAXKEY    MAXINT
+  #define SKIPL_LESS(A,B) ((A) < (B))
+  #define SKIPL_EQUAL(A,B) ((A) == (B))
   typedef int SkiplValueType;
 #endif
 
+/* an entry of a batch to insert */
+typedef struct {
+    SkiplKeyType   key;
+    SkiplValueType value;
+} SkiplEntryType;
+
 typedef struct SkipListStructure  *SkipList;
 typedef struct SkiplNodeStructure *SkiplNode;
 
+/* called with each node deleted by SkiplDeleteUpTo (it must not use the list) */
+typedef void (*SkiplCallback)(SkiplKeyType key, SkiplValueType value, void *arg);
+
 void SkiplInit(void);
 SkipList SkiplNew(void);
 void SkiplFree(SkipList l);
+void SkiplSeed(SkipList l, unsigned int seed);
 int  SkiplInsert(SkipList l, SkiplKeyType key, SkiplValueType value);
+SkiplNode SkiplInsertNode(SkipList l, SkiplKeyType key, SkiplValueType value);
+int  SkiplInsertSorted(SkipList l, SkiplEntryType e[], int n, SkiplNode nodes[]);
 int  SkiplDelete(SkipList l, SkiplKeyType key);
+void SkiplDeleteNode(SkipList l, SkiplNode n);
+int  SkiplDeleteUpTo(SkipList l, SkiplKeyType key, SkiplCallback callback, void *arg);
+int  SkiplPopMin(SkipList l, SkiplKeyType *keyPointer, SkiplValueType *valuePointer);
 int  SkiplSearch(SkipList l, SkiplKeyType key, SkiplValueType *valuePointer);
 
 SkiplNode SkiplHead(SkipList l);
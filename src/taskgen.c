@@ -0,0 +1,60 @@
+/*
+ * Routines to generate random task sets
+ *
+ * See taskgen.h
+ *
+ */
+
+#include <math.h>   /* for pow() */
+
+#include "taskgen.h"
+
+/* xorshift32 (Marsaglia): state can not be zero */
+double unirand(unsigned int *seed) {
+unsigned int x = *seed;
+
+    if( x == 0 ) x = 2463534242U;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *seed = x;
+    return (x>>8)/16777216.0;   /* 24 bits of mantissa */
+}
+
+/*
+ * UUniFast: the sum of the utilizations of tasks i..n-1 is uniformly
+ * distributed for each i, so next_sum = sum * r^(1/(n-i-1))
+ */
+void uunifast(int n, double u, double v[], unsigned int *seed) {
+double sum, next;
+int i;
+
+    sum = u;
+    for(i=0;i<n-1;i++) {
+        next = sum*pow(unirand(seed), 1.0/(n-i-1));
+        v[i] = sum-next;
+        sum = next;
+    }
+    v[n-1] = sum;
+}
+
+int divisors(int h, int min, int max, int d[], int size) {
+int i, n;
+
+    n = 0;
+    for(i=(min<1)?1:min; i<=max && i<=h && n<size; i++) {
+        if( h%i == 0 )
+            d[n++] = i;
+    }
+    return n;
+}
+
+void randomperiods(int n, int d[], int nd, int t[], unsigned int *seed) {
+int i, k;
+
+    for(i=0;i<n;i++) {
+        k = (int) (unirand(seed)*nd);
+        if( k >= nd ) k = nd-1;
+        t[i] = d[k];
+    }
+}
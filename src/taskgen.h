@@ -0,0 +1,31 @@
+#ifndef TASKGEN_H
+#define TASKGEN_H
+/*
+ * Routines to generate random task sets
+ *
+ * Routines:
+ *   double unirand(unsigned int *seed) returns a number uniformly
+ *                distributed in [0,1). The generator state is kept in
+ *                *seed, so each thread can have its own
+ *
+ *   void uunifast(int n, double u, double v[], unsigned int *seed)
+ *                splits the total utilization u among n tasks with
+ *                the UUniFast algorithm (Bini & Buttazzo), that gives
+ *                an uniform distribution of the vector v
+ *
+ *   int divisors(int h, int min, int max, int d[], int size) stores in d
+ *                the divisors of h in the range [min,max] in increasing
+ *                order and returns how many were found (at most size)
+ *
+ *   void randomperiods(int n, int d[], int nd, int t[], unsigned int *seed)
+ *                draws n periods from the nd divisors in d. As all periods
+ *                divide the same number, so does their lcm
+ *
+ */
+
+double unirand(unsigned int *seed);
+void uunifast(int n, double u, double v[], unsigned int *seed);
+int divisors(int h, int min, int max, int d[], int size);
+void randomperiods(int n, int d[], int nd, int t[], unsigned int *seed);
+
+#endif
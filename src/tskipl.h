@@ -0,0 +1,331 @@
+/******************************************************************************
+ *                  TSKIPL.H
+ * Typed skip list generator
+ *
+ * TSKIPL_DEFINE(P, KeyType, ValueType, LESS) defines a skip list of entries
+ * (KeyType, ValueType) ordered by LESS(a,b), a macro or inline function
+ * that is true when the key a goes before b. Two keys are equal when
+ * neither is less than the other. The key can be any type, such as a
+ * struct with a deadline, a priority and an id, and LESS is expanded in the
+ * search loops, so the comparison is compiled for that type.
+ *
+ * It defines the types P (the list) and P##Node, and static functions for
+ * the file where it is used:
+ *
+ *   P P##New(void), void P##Free(P l)
+ *   int P##Insert(P l, key, value) returns 0 if the key was already there
+ *                (and its value is replaced)
+ *   P##Node P##InsertNode(P l, key, value) the same, returning the node
+ *   int P##Delete(P l, key) returns 0 if the key was not there
+ *   void P##DeleteNode(P l, P##Node n) deletes the node (by its key)
+ *   int P##Search(P l, key, &value) returns 0 if the key is not there
+ *   int P##PopMin(P l, &key, &value) returns 0 if the list is empty
+ *   P##Node P##Head(P l), P##Node P##Next(P##Node n) iterate in key order
+ *   int P##IsEmpty(P l)
+ *
+ * A node begins with its key and its value (n->key, n->value).
+ *****************************************************************************/
+#ifndef TSKIPL_H
+#define TSKIPL_H
+
+#include <stdio.h>  /* for stderr */
+#include <stdlib.h> /* for malloc() */
+
+/* for p=1/4 enough for 4^16 nodes */
+#define TSKIPL_MAXLEVELS    16
+/* initial state of the random generator of each list */
+#define TSKIPL_SEED         2463534242U
+
+#define TSKIPL_DEFINE(P, KeyType, ValueType, LESS)                            \
+                                                                              \
+typedef struct P##NodeStructure {                                             \
+    KeyType key;                                                              \
+    ValueType value;                                                          \
+    int level;                                                                \
+    struct P##NodeStructure *forward[1];    /* level+1 used */                \
+} *P##Node;                                                                   \
+                                                                              \
+typedef struct P##Structure {                                                 \
+    int level;                                                                \
+    unsigned int seed;                                                        \
+    P##Node header;                                                           \
+    P##Node freeNodes[TSKIPL_MAXLEVELS];    /* linked by forward[0] */        \
+} *P;                                                                         \
+                                                                              \
+static inline P##Node P##NewNode_(P l, int level)                             \
+{                                                                             \
+    P##Node n;                                                                \
+                                                                              \
+    if( (n=l->freeNodes[level]) != NULL ) {                                   \
+        l->freeNodes[level] = n->forward[0];                                  \
+        return n;                                                             \
+    }                                                                         \
+    n = malloc(sizeof(struct P##NodeStructure) + level*sizeof(P##Node));      \
+    if( n == NULL ) {                                                         \
+        fprintf(stderr, "Insufficient memory available");                     \
+        exit(-1);                                                             \
+    }                                                                         \
+    n->level = level;                                                         \
+    return n;                                                                 \
+}                                                                             \
+                                                                              \
+/* xorshift32, p=1/4 for each level */                                        \
+static inline int P##RandomLevel_(P l)                                        \
+{                                                                             \
+    unsigned int x = l->seed;                                                 \
+    int level = 0;                                                            \
+                                                                              \
+    x ^= x << 13;                                                             \
+    x ^= x >> 17;                                                             \
+    x ^= x << 5;                                                              \
+    l->seed = x;                                                              \
+    while( (x&3) == 0 && level < TSKIPL_MAXLEVELS-1 ) {                       \
+        level++;                                                              \
+        x >>= 2;                                                              \
+    }                                                                         \
+    return level;                                                             \
+}                                                                             \
+                                                                              \
+/* update[k] is the last node of level k before 'key'. Returns its node */  \
+static inline P##Node P##Find_(P l, KeyType key, P##Node update[])            \
+{                                                                             \
+    P##Node p, q;                                                             \
+    int k;                                                                    \
+                                                                              \
+    p = l->header;                                                            \
+    for(k=l->level; k>=0; k--) {                                              \
+        while( (q=p->forward[k]) != NULL && LESS(q->key, key) )               \
+            p = q;                                                            \
+        update[k] = p;                                                        \
+    }                                                                         \
+    q = p->forward[0];                                                        \
+    return (q != NULL && !LESS(key, q->key))? q : NULL;                       \
+}                                                                             \
+                                                                              \
+static inline void P##Unlink_(P l, P##Node q, P##Node update[])               \
+{                                                                             \
+    int k;                                                                    \
+                                                                              \
+    for(k=0; k<=q->level; k++)                                                \
+        update[k]->forward[k] = q->forward[k];                                \
+    q->forward[0] = l->freeNodes[q->level];                                   \
+    l->freeNodes[q->level] = q;                                               \
+    while( l->level > 0 && l->header->forward[l->level] == NULL )             \
+        l->level--;                                                           \
+}                                                                             \
+                                                                              \
+static inline P P##New(void)                                                  \
+{                                                                             \
+    P l;                                                                      \
+    int k;                                                                    \
+                                                                              \
+    if( (l=calloc(1, sizeof(struct P##Structure))) == NULL ) {                \
+        fprintf(stderr, "Insufficient memory available");                     \
+        exit(-1);                                                             \
+    }                                                                         \
+    l->seed = TSKIPL_SEED;                                                    \
+    l->header = P##NewNode_(l, TSKIPL_MAXLEVELS-1);                           \
+    for(k=0; k<TSKIPL_MAXLEVELS; k++)                                         \
+        l->header->forward[k] = NULL;                                         \
+    return l;                                                                 \
+}                                                                             \
+                                                                              \
+static inline void P##Free(P l)                                               \
+{                                                                             \
+    P##Node p, q;                                                             \
+    int k;                                                                    \
+                                                                              \
+    for(p=l->header; p!=NULL; p=q) {                                          \
+        q = p->forward[0];                                                    \
+        free(p);                                                              \
+    }                                                                         \
+    for(k=0; k<TSKIPL_MAXLEVELS; k++) {                                       \
+        for(p=l->freeNodes[k]; p!=NULL; p=q) {                                \
+            q = p->forward[0];                                                \
+            free(p);                                                          \
+        }                                                                     \
+    }                                                                         \
+    free(l);                                                                  \
+}                                                                             \
+                                                                              \
+/* the node with the key is stored in *node. Returns 0 if it was there */     \
+static inline int P##Add_(P l, KeyType key, ValueType value, P##Node *node)   \
+{                                                                             \
+    P##Node update[TSKIPL_MAXLEVELS];                                         \
+    P##Node q;                                                                \
+    int k, level;                                                             \
+                                                                              \
+    if( (q=*node=P##Find_(l, key, update)) != NULL ) {                        \
+        q->value = value;                                                     \
+        return 0;                                                             \
+    }                                                                         \
+    level = P##RandomLevel_(l);                                               \
+    if( level > l->level ) {                                                  \
+        for(k=l->level+1; k<=level; k++)                                      \
+            update[k] = l->header;                                            \
+        l->level = level;                                                     \
+    }                                                                         \
+    q = *node = P##NewNode_(l, level);                                        \
+    q->key = key;                                                             \
+    q->value = value;                                                         \
+    for(k=0; k<=level; k++) {                                                 \
+        q->forward[k] = update[k]->forward[k];                                \
+        update[k]->forward[k] = q;                                            \
+    }                                                                         \
+    return 1;                                                                 \
+}                                                                             \
+                                                                              \
+static inline int P##Insert(P l, KeyType key, ValueType value)                \
+{                                                                             \
+    P##Node q;                                                                \
+                                                                              \
+    return P##Add_(l, key, value, &q);                                        \
+}                                                                             \
+                                                                              \
+static inline P##Node P##InsertNode(P l, KeyType key, ValueType value)        \
+{                                                                             \
+    P##Node q;                                                                \
+                                                                              \
+    P##Add_(l, key, value, &q);                                               \
+    return q;                                                                 \
+}                                                                             \
+                                                                              \
+static inline int P##Delete(P l, KeyType key)                                 \
+{                                                                             \
+    P##Node update[TSKIPL_MAXLEVELS];                                         \
+    P##Node q;                                                                \
+                                                                              \
+    if( (q=P##Find_(l, key, update)) == NULL )                                \
+        return 0;                                                             \
+    P##Unlink_(l, q, update);                                                 \
+    return 1;                                                                 \
+}                                                                             \
+                                                                              \
+static inline void P##DeleteNode(P l, P##Node n)                              \
+{                                                                             \
+    P##Delete(l, n->key);                                                     \
+}                                                                             \
+                                                                              \
+static inline int P##Search(P l, KeyType key, ValueType *valuePointer)        \
+{                                                                             \
+    P##Node update[TSKIPL_MAXLEVELS];                                         \
+    P##Node q;                                                                \
+                                                                              \
+    if( (q=P##Find_(l, key, update)) == NULL )                                \
+        return 0;                                                             \
+    *valuePointer = q->value;                                                 \
+    return 1;                                                                 \
+}                                                                             \
+                                                                              \
+/* the first node has the header before it in all its levels */              \
+static inline int P##PopMin(P l, KeyType *keyPointer, ValueType *valuePointer) \
+{                                                                             \
+    P##Node update[TSKIPL_MAXLEVELS];                                         \
+    P##Node q;                                                                \
+    int k;                                                                    \
+                                                                              \
+    if( (q=l->header->forward[0]) == NULL )                                   \
+        return 0;                                                             \
+    *keyPointer = q->key;                                                     \
+    *valuePointer = q->value;                                                 \
+    for(k=0; k<=q->level; k++)                                                \
+        update[k] = l->header;                                                \
+    P##Unlink_(l, q, update);                                                 \
+    return 1;                                                                 \
+}                                                                             \
+                                                                              \
+static inline P##Node P##Head(P l)                                            \
+{                                                                             \
+    return l->header->forward[0];                                             \
+}                                                                             \
+                                                                              \
+static inline P##Node P##Next(P##Node n)                                      \
+{                                                                             \
+    return n->forward[0];                                                     \
+}                                                                             \
+                                                                              \
+static inline int P##IsEmpty(P l)                                             \
+{                                                                             \
+    return l->header->forward[0] == NULL;                                     \
+}
+
+
+#ifdef TSKIPL_TEST
+/* keys of three fields, checked against an array of flags */
+#define sampleSize 5000
+
+typedef struct {
+    long long deadline;
+    int priority;
+    int id;
+} TestKey;
+
+#define TEST_LESS(A,B) ((A).deadline < (B).deadline || ((A).deadline == (B).deadline \
+    && ((A).priority < (B).priority || ((A).priority == (B).priority && (A).id < (B).id))))
+
+TSKIPL_DEFINE(TestList, TestKey, int, TEST_LESS)
+
+static int present[sampleSize];
+
+static TestKey testkey(int i)
+{
+    TestKey key;
+
+    key.deadline = i/20;
+    key.priority = (i/4)%5;
+    key.id = i%4;
+    return key;
+}
+
+int main(void)
+{
+    TestList l;
+    TestListNode n;
+    TestKey key, last;
+    int i, k, v, errors = 0;
+
+    l = TestListNew();
+    srand(1);
+    for(i=0; i<20*sampleSize; i++) {
+        k = rand()%sampleSize;
+        if( rand()%3 ) {
+            if( TestListInsert(l, testkey(k), k) == present[k] )
+                errors++;
+            present[k] = 1;
+        } else if( rand()%2 && present[k] ) {
+            n = TestListInsertNode(l, testkey(k), k);
+            TestListDeleteNode(l, n);
+            present[k] = 0;
+        } else {
+            if( TestListDelete(l, testkey(k)) != present[k] )
+                errors++;
+            present[k] = 0;
+        }
+    }
+    for(k=0; k<sampleSize; k++) {
+        if( TestListSearch(l, testkey(k), &v) != present[k] || (present[k] && v != k) )
+            errors++;
+    }
+    last = testkey(0);
+    last.deadline = -1;
+    for(n=TestListHead(l); n!=NULL; n=TestListNext(n)) {
+        if( !TEST_LESS(last, n->key) )
+            errors++;
+        last = n->key;
+    }
+    while( TestListPopMin(l, &key, &v) ) {
+        if( !present[v] )
+            errors++;
+        present[v] = 0;
+    }
+    for(k=0; k<sampleSize; k++)
+        errors += present[k];
+    if( !TestListIsEmpty(l) )
+        errors++;
+    TestListFree(l);
+    printf("%d errors\n", errors);
+    return errors != 0;
+}
+#endif /* TSKIPL_TEST */
+
+#endif /* TSKIPL_H */
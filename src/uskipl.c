@@ -0,0 +1,402 @@
+/*
+ * Unrolled skip list
+ *
+ * See uskipl.h
+ *
+ * The list is a sequence of blocks of BlockSize bytes, each with up to
+ * BlockEntries (key,value) pairs in increasing key order, and the blocks
+ * are the nodes of a skip list ordered by the key of their first entry.
+ * A search goes down the levels to the last block whose first key is less
+ * than the key, and then along the entries of the block (or the next one).
+ *
+ * A full block is split in two halves. A block is freed when it gets empty
+ * and blocks are not merged otherwise. The blocks are aligned to their
+ * size, so the block of an entry is found from its address.
+ *
+ * Blocks of 512 bytes hold 17 entries with 16 byte keys, so a scan of the
+ * list reads eight cache lines per block instead of one node per entry.
+ */
+
+#include <stdio.h>  /* for stderr */
+#include <stdlib.h> /* for aligned_alloc() */
+#include <string.h> /* for memmove() */
+#include <stddef.h> /* for offsetof() */
+#include <stdint.h> /* for uintptr_t */
+
+#ifdef DMALLOC
+#include "dmalloc.h"
+#endif
+
+#include "uskipl.h"
+
+/* bytes per block, a power of two */
+#define BlockSize       512
+/* levels of the index of the blocks (for p=1/4 enough for 4^12 blocks) */
+#define BlockLevels     12
+/* initial state of the random generator of each list */
+#define DefaultSeed     2463534242U
+
+#define false 0
+#define true 1
+
+struct UskiplBlockStructure {
+    int n;                                      /* entries used */
+    int level;                                  /* levels 0 to level */
+    struct UskiplBlockStructure *forward[BlockLevels];
+    SkiplEntryType e[1];                        /* up to BlockEntries */
+};
+
+typedef struct UskiplBlockStructure *Block;
+
+#define BlockEntries \
+    ((int) ((BlockSize - offsetof(struct UskiplBlockStructure, e)) / sizeof(SkiplEntryType)))
+#define BlockOf(N)      ((Block) ((uintptr_t) (N) & ~(uintptr_t) (BlockSize-1)))
+
+struct UskiplStructure {
+    int level;                                  /* highest level used */
+    unsigned int seed;                          /* state of the random generator */
+    Block freeBlocks;                           /* linked by forward[0] */
+    struct UskiplBlockStructure header;         /* only its forward[] is used */
+};
+
+
+static Block newBlock(Uskipl l)
+{
+    Block b;
+
+    if( (b=l->freeBlocks) != NULL ) {
+        l->freeBlocks = b->forward[0];
+    } else if( (b=aligned_alloc(BlockSize, BlockSize)) == NULL ) {
+        fprintf(stderr, "Insufficient memory available");
+        exit(-1);
+    }
+    b->n = 0;
+    return b;
+}
+
+/* xorshift32, p=1/4 for each level */
+static int randomLevel(Uskipl l)
+{
+    unsigned int x = l->seed;
+    int level = 0;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    l->seed = x;
+    while( (x&3) == 0 && level < BlockLevels-1 ) {
+        level++;
+        x >>= 2;
+    }
+    return level;
+}
+
+/*
+ * update[k] is the last block of level k whose first key is less than
+ * 'key' (or the header). Returns update[0]
+ */
+static Block search(Uskipl l, SkiplKeyType key, Block update[])
+{
+    Block p, q;
+    int k;
+
+    p = &l->header;
+    for(k=l->level; k>=0; k--) {
+        while( (q=p->forward[k]) != NULL && SKIPL_LESS(q->e[0].key, key) )
+            p = q;
+        update[k] = p;
+    }
+    return p;
+}
+
+/* index of the first entry of b with a key not less than 'key' */
+static int position(Block b, SkiplKeyType key)
+{
+    int i;
+
+    for(i=0; i<b->n && SKIPL_LESS(b->e[i].key, key); i++)
+        ;
+    return i;
+}
+
+/* the block b, that already has its entries, goes into the list */
+static void linkBlock(Uskipl l, Block b)
+{
+    Block update[BlockLevels];
+    int k;
+
+    search(l, b->e[0].key, update);
+    b->level = randomLevel(l);
+    for(k=l->level+1; k<=b->level; k++)
+        update[k] = &l->header;
+    if( b->level > l->level )
+        l->level = b->level;
+    for(k=0; k<=b->level; k++) {
+        b->forward[k] = update[k]->forward[k];
+        update[k]->forward[k] = b;
+    }
+}
+
+/* update[k] is the block before b in level k */
+static void unlinkBlock(Uskipl l, Block b, Block update[])
+{
+    int k;
+
+    for(k=0; k<=b->level; k++)
+        update[k]->forward[k] = b->forward[k];
+    b->forward[0] = l->freeBlocks;
+    l->freeBlocks = b;
+    while( l->level > 0 && l->header.forward[l->level] == NULL )
+        l->level--;
+}
+
+/* the first block has the header before it in all its levels */
+static void unlinkFirst(Uskipl l)
+{
+    Block update[BlockLevels];
+    int k;
+
+    for(k=0; k<BlockLevels; k++)
+        update[k] = &l->header;
+    unlinkBlock(l, l->header.forward[0], update);
+}
+
+/* the second half of the entries of b go to a new block after it */
+static void splitBlock(Uskipl l, Block b)
+{
+    Block c = newBlock(l);
+
+    c->n = b->n/2;
+    b->n -= c->n;
+    memcpy(c->e, b->e+b->n, c->n*sizeof(SkiplEntryType));
+    linkBlock(l, c);
+}
+
+/* the entry i of b is deleted (update is needed if it is the only one) */
+static void removeEntry(Uskipl l, Block b, int i, Block update[])
+{
+    if( --b->n == 0 ) {
+        unlinkBlock(l, b, update);
+        return;
+    }
+    memmove(b->e+i, b->e+i+1, (b->n-i)*sizeof(SkiplEntryType));
+}
+
+
+Uskipl UskiplNew(void)
+{
+    Uskipl l;
+
+    if( (l=calloc(1, sizeof(struct UskiplStructure))) == NULL ) {
+        fprintf(stderr, "Insufficient memory available");
+        exit(-1);
+    }
+    l->seed = DefaultSeed;
+    return l;
+}
+
+void UskiplFree(Uskipl l)
+{
+    Block b;
+
+    while( (b=l->header.forward[0]) != NULL ) {
+        l->header.forward[0] = b->forward[0];
+        free(b);
+    }
+    while( (b=l->freeBlocks) != NULL ) {
+        l->freeBlocks = b->forward[0];
+        free(b);
+    }
+    free(l);
+}
+
+int UskiplInsert(Uskipl l, SkiplKeyType key, SkiplValueType value)
+{
+    Block update[BlockLevels];
+    Block b, q;
+    int i;
+
+    b = search(l, key, update);
+    q = b->forward[0];
+    if( q != NULL && SKIPL_EQUAL(q->e[0].key, key) ) {
+        q->e[0].value = value;
+        return false;
+    }
+    if( b == &l->header ) {
+        if( q == NULL ) {   /* empty list */
+            b = newBlock(l);
+            b->n = 1;
+            b->e[0].key = key;
+            b->e[0].value = value;
+            linkBlock(l, b);
+            return true;
+        }
+        b = q;  /* less than all keys: at the front of the first block */
+    }
+    i = position(b, key);
+    if( i < b->n && SKIPL_EQUAL(b->e[i].key, key) ) {
+        b->e[i].value = value;
+        return false;
+    }
+    if( b->n == BlockEntries ) {
+        splitBlock(l, b);
+        if( i > b->n ) {
+            i -= b->n;
+            b = b->forward[0];
+        }
+    }
+    memmove(b->e+i+1, b->e+i, (b->n-i)*sizeof(SkiplEntryType));
+    b->e[i].key = key;
+    b->e[i].value = value;
+    b->n++;
+    return true;
+}
+
+int UskiplDelete(Uskipl l, SkiplKeyType key)
+{
+    Block update[BlockLevels];
+    Block b, q;
+    int i;
+
+    b = search(l, key, update);
+    q = b->forward[0];
+    if( q != NULL && SKIPL_EQUAL(q->e[0].key, key) ) {
+        removeEntry(l, q, 0, update);
+        return true;
+    }
+    if( b == &l->header )
+        return false;
+    /* the key is not the first one of b, so b does not get empty */
+    i = position(b, key);
+    if( i == b->n || !SKIPL_EQUAL(b->e[i].key, key) )
+        return false;
+    removeEntry(l, b, i, NULL);
+    return true;
+}
+
+int UskiplPopMin(Uskipl l, SkiplKeyType *keyPointer, SkiplValueType *valuePointer)
+{
+    Block b = l->header.forward[0];
+
+    if( b == NULL )
+        return false;
+    *keyPointer = b->e[0].key;
+    *valuePointer = b->e[0].value;
+    if( b->n == 1 )
+        unlinkFirst(l);
+    else
+        memmove(b->e, b->e+1, --b->n*sizeof(SkiplEntryType));
+    return true;
+}
+
+/* whole blocks are dropped from the front, the last one is shifted */
+int UskiplDeleteUpTo(Uskipl l, SkiplKeyType key, SkiplCallback callback, void *arg)
+{
+    Block b;
+    int i, count = 0;
+
+    while( (b=l->header.forward[0]) != NULL ) {
+        for(i=0; i<b->n && !SKIPL_LESS(key, b->e[i].key); i++) {
+            if( callback != NULL )
+                (*callback)(b->e[i].key, b->e[i].value, arg);
+        }
+        count += i;
+        if( i < b->n ) {
+            b->n -= i;
+            memmove(b->e, b->e+i, b->n*sizeof(SkiplEntryType));
+            break;
+        }
+        unlinkFirst(l);
+    }
+    return count;
+}
+
+UskiplNode UskiplHead(Uskipl l)
+{
+    Block b = l->header.forward[0];
+
+    return b? b->e : NULL;
+}
+
+UskiplNode UskiplNext(UskiplNode n)
+{
+    Block b = BlockOf(n);
+
+    if( n+1 < b->e+b->n )
+        return n+1;
+    b = b->forward[0];
+    return b? b->e : NULL;
+}
+
+int UskiplIsEmpty(Uskipl l)
+{
+    return l->header.forward[0] == NULL;
+}
+
+
+#ifdef USKIPL_TEST
+/* random inserts and deletes checked against an array of flags */
+#define sampleSize 5000
+
+static int present[sampleSize];
+static int count;
+
+static void count_entry(SkiplKeyType key, SkiplValueType value, void *arg)
+{
+    present[key.key] = 0;
+    count++;
+}
+
+int main(void)
+{
+    Uskipl l;
+    UskiplNode n;
+    SkiplKeyType key, last;
+    SkiplValueType v;
+    int i, k, errors = 0;
+
+    l = UskiplNew();
+    srand(1);
+    for(i=0; i<20*sampleSize; i++) {
+        k = rand()%sampleSize;
+        key.key = k;
+        key.tie = k%7;
+        if( rand()%3 ) {
+            if( UskiplInsert(l, key, NULL) == present[k] )
+                errors++;
+            present[k] = 1;
+        } else {
+            if( UskiplDelete(l, key) != present[k] )
+                errors++;
+            present[k] = 0;
+        }
+    }
+    for(k=0, i=0; k<sampleSize; k++)
+        i += present[k];
+    last.key = -1;
+    last.tie = 0;
+    for(n=UskiplHead(l); n!=NULL; n=UskiplNext(n)) {
+        if( !SKIPL_LESS(last, n->key) || !present[n->key.key] )
+            errors++;
+        last = n->key;
+        i--;
+    }
+    if( i != 0 )
+        errors++;
+    key.key = sampleSize/2;
+    key.tie = 7;
+    UskiplDeleteUpTo(l, key, count_entry, NULL);
+    for(k=0; k<=sampleSize/2; k++)
+        errors += present[k];
+    while( UskiplPopMin(l, &key, &v) ) {
+        if( !present[key.key] )
+            errors++;
+        present[key.key] = 0;
+    }
+    for(k=0; k<sampleSize; k++)
+        errors += present[k];
+    UskiplFree(l);
+    printf("%d entries per block, %d errors\n", BlockEntries, errors);
+    return errors != 0;
+}
+#endif /* USKIPL_TEST */
@@ -0,0 +1,32 @@
+/******************************************************************************
+ *                  USKIPL.H
+ * Unrolled skip list interface
+ *
+ * The entries are kept in order in blocks of contiguous (key,value) pairs
+ * of a few cache lines, and the levels of the skip list link the blocks
+ * (ordered by their first key), so walking the entries in order touches
+ * memory sequentially. The keys are the ones of skipl.h.
+ *
+ * An entry moves when others are inserted or deleted in its block, so a
+ * UskiplNode is only valid until the list changes.
+ *****************************************************************************/
+#ifndef USKIPL_H
+#define USKIPL_H
+
+#include "skipl.h"
+
+typedef struct UskiplStructure *Uskipl;
+typedef SkiplEntryType *UskiplNode;
+
+Uskipl UskiplNew(void);
+void UskiplFree(Uskipl l);
+int  UskiplInsert(Uskipl l, SkiplKeyType key, SkiplValueType value);
+int  UskiplDelete(Uskipl l, SkiplKeyType key);
+int  UskiplPopMin(Uskipl l, SkiplKeyType *keyPointer, SkiplValueType *valuePointer);
+int  UskiplDeleteUpTo(Uskipl l, SkiplKeyType key, SkiplCallback callback, void *arg);
+
+UskiplNode UskiplHead(Uskipl l);
+UskiplNode UskiplNext(UskiplNode n);
+int UskiplIsEmpty(Uskipl l);
+
+#endif /* USKIPL_H */
@@ -0,0 +1,219 @@
+/*
+ * Work-stealing pool of worker threads
+ *
+ * The queues are circular buffers protected by a mutex each. Jobs are
+ * coarse (a whole task set simulation), so the locking cost does not
+ * matter and the owner and the thieves work at opposite ends of a queue.
+ *
+ * 'pending' counts the jobs queued and not taken yet. Workers sleep on
+ * 'work' only when it is zero.
+ *
+ */
+
+#include <stdio.h>  /* for stderr */
+#include <stdlib.h> /* for malloc() */
+#include <pthread.h>
+
+#ifdef DMALLOC
+#include "dmalloc.h"
+#endif
+
+#include "workpool.h"
+
+#define INITIALQUEUESIZE 64
+
+struct WorkQueueStructure {
+    pthread_mutex_t lock;
+    void **items;
+    int first;      /* position of the front item */
+    int count;      /* number of items in the queue */
+    int size;       /* allocated size of items */
+};
+
+struct WorkpoolStructure {
+    int n;                              /* number of workers */
+    struct WorkQueueStructure *queues;  /* one per worker */
+    pthread_t *threads;
+    void (*run)(void *job, int worker);
+
+    pthread_mutex_t lock;
+    pthread_cond_t work;
+    int pending;
+    int shutdown;
+    int next;                           /* next queue to receive a job */
+};
+
+struct WorkerStructure {
+    Workpool pool;
+    int id;
+};
+
+static void pushback(struct WorkQueueStructure *q, void *job)
+{
+    void **items;
+    int i;
+
+    pthread_mutex_lock(&q->lock);
+    if( q->count == q->size ) {
+        if( (items = malloc(2*q->size*sizeof(void *))) == NULL ) {
+            fprintf(stderr, "Insufficient memory available");
+            exit(-1);
+        }
+        for(i=0;i<q->count;i++)
+            items[i] = q->items[(q->first+i)%q->size];
+        free(q->items);
+        q->items = items;
+        q->first = 0;
+        q->size *= 2;
+    }
+    q->items[(q->first+q->count)%q->size] = job;
+    q->count++;
+    pthread_mutex_unlock(&q->lock);
+}
+
+/* the owner takes from the front */
+static void *popfront(struct WorkQueueStructure *q)
+{
+    void *job = NULL;
+
+    pthread_mutex_lock(&q->lock);
+    if( q->count > 0 ) {
+        job = q->items[q->first];
+        q->first = (q->first+1)%q->size;
+        q->count--;
+    }
+    pthread_mutex_unlock(&q->lock);
+    return job;
+}
+
+/* thieves take from the back */
+static void *popback(struct WorkQueueStructure *q)
+{
+    void *job = NULL;
+
+    pthread_mutex_lock(&q->lock);
+    if( q->count > 0 ) {
+        q->count--;
+        job = q->items[(q->first+q->count)%q->size];
+    }
+    pthread_mutex_unlock(&q->lock);
+    return job;
+}
+
+static void *worker(void *arg)
+{
+    struct WorkerStructure *w = arg;
+    Workpool p = w->pool;
+    void *job;
+    int i;
+
+    for(;;) {
+        job = popfront(p->queues+w->id);
+        for(i=1; job==NULL && i<p->n; i++)
+            job = popback(p->queues+(w->id+i)%p->n);
+
+        pthread_mutex_lock(&p->lock);
+        if( job != NULL ) {
+            p->pending--;
+        } else {
+            while( p->pending == 0 && !p->shutdown )
+                pthread_cond_wait(&p->work, &p->lock);
+            if( p->pending == 0 ) {     /* and shutdown */
+                pthread_mutex_unlock(&p->lock);
+                break;
+            }
+        }
+        pthread_mutex_unlock(&p->lock);
+
+        if( job != NULL )
+            (p->run)(job, w->id);
+    }
+    free(w);
+    return NULL;
+}
+
+Workpool WorkpoolNew(int n, void (*run)(void *job, int worker))
+{
+    Workpool p;
+    struct WorkerStructure *w;
+    int i;
+
+    if( n < 1 ) n = 1;
+    if( (p = malloc(sizeof(struct WorkpoolStructure))) == NULL
+        || (p->queues = malloc(n*sizeof(struct WorkQueueStructure))) == NULL
+        || (p->threads = malloc(n*sizeof(pthread_t))) == NULL ) {
+        fprintf(stderr, "Insufficient memory available");
+        exit(-1);
+    }
+    p->n = n;
+    p->run = run;
+    p->pending = 0;
+    p->shutdown = 0;
+    p->next = 0;
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->work, NULL);
+    for(i=0;i<n;i++) {
+        pthread_mutex_init(&p->queues[i].lock, NULL);
+        p->queues[i].first = 0;
+        p->queues[i].count = 0;
+        p->queues[i].size = INITIALQUEUESIZE;
+        if( (p->queues[i].items = malloc(INITIALQUEUESIZE*sizeof(void *))) == NULL ) {
+            fprintf(stderr, "Insufficient memory available");
+            exit(-1);
+        }
+    }
+    for(i=0;i<n;i++) {
+        if( (w = malloc(sizeof(struct WorkerStructure))) == NULL ) {
+            fprintf(stderr, "Insufficient memory available");
+            exit(-1);
+        }
+        w->pool = p;
+        w->id = i;
+        if( pthread_create(p->threads+i, NULL, worker, w) != 0 ) {
+            fprintf(stderr, "Can't create worker thread");
+            exit(-1);
+        }
+    }
+    return p;
+}
+
+void WorkpoolSubmit(Workpool p, void *jobs[], int n)
+{
+    int i;
+
+    pthread_mutex_lock(&p->lock);
+    p->pending += n;
+    pthread_mutex_unlock(&p->lock);
+
+    for(i=0;i<n;i++) {
+        pushback(p->queues+p->next, jobs[i]);
+        p->next = (p->next+1)%p->n;
+    }
+
+    pthread_mutex_lock(&p->lock);
+    pthread_cond_broadcast(&p->work);
+    pthread_mutex_unlock(&p->lock);
+}
+
+void WorkpoolFree(Workpool p)
+{
+    int i;
+
+    pthread_mutex_lock(&p->lock);
+    p->shutdown = 1;
+    pthread_cond_broadcast(&p->work);
+    pthread_mutex_unlock(&p->lock);
+
+    for(i=0;i<p->n;i++)
+        pthread_join(p->threads[i], NULL);
+
+    for(i=0;i<p->n;i++) {
+        pthread_mutex_destroy(&p->queues[i].lock);
+        free(p->queues[i].items);
+    }
+    pthread_cond_destroy(&p->work);
+    pthread_mutex_destroy(&p->lock);
+    free(p->threads);
+    free(p->queues);
+    free(p);
+}
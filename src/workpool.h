@@ -0,0 +1,30 @@
+#ifndef WORKPOOL_H
+#define WORKPOOL_H
+/*
+ * Work-stealing pool of worker threads
+ *
+ * Each worker has its own double ended queue of jobs. A worker takes jobs
+ * from the front of its own queue and, when it is empty, steals from the
+ * back of the queues of the other workers.
+ *
+ * Routines:
+ *   Workpool WorkpoolNew(int n, run) starts n workers that call
+ *                run(job,worker) for each job submitted
+ *
+ *   void WorkpoolSubmit(Workpool p, void *jobs[], int n) distributes the
+ *                n jobs round robin among the workers. When the jobs are
+ *                sorted by decreasing cost, each worker starts with its
+ *                longest jobs and the short ones are left to be stolen
+ *
+ *   void WorkpoolFree(Workpool p) waits until all jobs submitted are done,
+ *                stops the workers and releases the pool
+ *
+ */
+
+typedef struct WorkpoolStructure *Workpool;
+
+Workpool WorkpoolNew(int n, void (*run)(void *job, int worker));
+void WorkpoolSubmit(Workpool p, void *jobs[], int n);
+void WorkpoolFree(Workpool p);
+
+#endif